@@ -0,0 +1,118 @@
+#include "BaselineReporter.h"
+#include <algorithm>
+#include <crow.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+	double Median(std::vector<double> samples)
+	{
+		std::sort(samples.begin(), samples.end());
+		size_t middle = samples.size() / 2;
+		return samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+	}
+
+	double NanosecondsPerUnit(const std::string& unit)
+	{
+		if (unit == "ns") return 1.0;
+		if (unit == "us") return 1e3;
+		if (unit == "ms") return 1e6;
+		if (unit == "s") return 1e9;
+		throw std::runtime_error("Unknown time unit in baseline: " + unit);
+	}
+}
+
+// Only plain iterations are kept; aggregates are recomputed from them so both sides agree
+void BaselineReporter::ReportRuns(const std::vector<Run>& runs)
+{
+	benchmark::ConsoleReporter::ReportRuns(runs);
+
+	for (const Run& run : runs) {
+		if (run.run_type != Run::RT_Iteration || run.iterations == 0) {
+			continue;
+		}
+		double nanoseconds = run.GetAdjustedCPUTime() / benchmark::GetTimeUnitMultiplier(run.time_unit) * 1e9;
+		m_samples[run.run_name.str()].push_back(nanoseconds);
+	}
+}
+
+BenchmarkTimes BaselineReporter::GetTimes() const
+{
+	BenchmarkTimes times;
+	for (const auto& [name, samples] : m_samples) {
+		times[name] = Median(samples);
+	}
+	return times;
+}
+
+namespace baseline {
+	BenchmarkTimes Load(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file) {
+			throw std::runtime_error("Cannot open baseline " + path);
+		}
+		std::stringstream text;
+		text << file.rdbuf();
+
+		auto json = crow::json::load(text.str());
+		if (!json || !json.has("benchmarks")) {
+			throw std::runtime_error("Not a benchmark JSON file: " + path);
+		}
+
+		std::map<std::string, std::vector<double>> samples;
+		const crow::json::rvalue& benchmarks = json["benchmarks"];
+		for (size_t index = 0; index < benchmarks.size(); ++index) {
+			const crow::json::rvalue& entry = benchmarks[index];
+			if (entry.has("run_type") && std::string(entry["run_type"].s()) != "iteration") {
+				continue;
+			}
+			std::string name = entry.has("run_name") ? std::string(entry["run_name"].s()) : std::string(entry["name"].s());
+			samples[name].push_back(entry["cpu_time"].d() * NanosecondsPerUnit(entry["time_unit"].s()));
+		}
+
+		BenchmarkTimes times;
+		for (const auto& [name, values] : samples) {
+			times[name] = Median(values);
+		}
+		return times;
+	}
+
+	int Compare(const BenchmarkTimes& current, const BenchmarkTimes& reference, double tolerance)
+	{
+		int regressions = 0;
+		int compared = 0;
+		int missing = 0;
+		std::cout << "\nComparison with baseline (CPU time, tolerance " << tolerance * 100.0 << "%)\n"
+			<< std::left << std::setw(48) << "benchmark" << std::right
+			<< std::setw(14) << "baseline ns" << std::setw(14) << "current ns" << std::setw(10) << "change" << "\n";
+
+		std::cout << std::fixed;
+		for (const auto& [name, nanoseconds] : current) {
+			auto base = reference.find(name);
+			if (base == reference.end() || base->second <= 0.0) {
+				++missing;
+				std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << "-"
+					<< std::setw(14) << std::setprecision(1) << nanoseconds << std::setw(10) << "missing" << "\n";
+				continue;
+			}
+
+			++compared;
+			double change = nanoseconds / base->second - 1.0;
+			bool regressed = change > tolerance;
+			regressions += regressed;
+			std::cout << std::left << std::setw(48) << name << std::right
+				<< std::setw(14) << std::setprecision(1) << base->second
+				<< std::setw(14) << nanoseconds
+				<< std::setw(9) << std::showpos << std::setprecision(1) << change * 100.0 << "%" << std::noshowpos
+				<< (regressed ? "  REGRESSION" : "") << "\n";
+		}
+
+		std::cout << compared << " compared, " << regressions << " slower than the baseline allows, "
+			<< missing << " missing from the baseline" << std::endl;
+		return regressions + missing;
+	}
+}
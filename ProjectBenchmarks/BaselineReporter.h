@@ -0,0 +1,35 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// CPU time per iteration in nanoseconds, by benchmark name (e.g. "BM_Move/256/4")
+using BenchmarkTimes = std::map<std::string, double>;
+
+// Prints like the console reporter and keeps the CPU time of every run, so the results
+// can be checked against a baseline once all benchmarks are done. With repetitions the
+// median of the repetitions is used, on both sides.
+class BaselineReporter : public benchmark::ConsoleReporter
+{
+private:
+    // Member Variables
+    std::map<std::string, std::vector<double>> m_samples;
+
+public:
+    // Reporting
+    void ReportRuns(const std::vector<Run>& runs) override;
+
+    // Getters
+    BenchmarkTimes GetTimes() const;
+};
+
+namespace baseline {
+    // Reads a file written with --benchmark_out=<file> --benchmark_out_format=json
+    BenchmarkTimes Load(const std::string& path);
+
+    // Prints every benchmark that ran with its change and flags the ones more than `tolerance`
+    // (a fraction) slower; returns how many regressed plus how many the baseline lacks, so a
+    // partial baseline cannot pass a benchmark it never measured
+    int Compare(const BenchmarkTimes& current, const BenchmarkTimes& reference, double tolerance);
+}
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "BoardFixtures.h"
+#include "..\ProjectServer\MapGenerator.h"
+
+namespace {
+	const double TICK_SECONDS = 0.05; // one tick at the server's 20 ticks per second
+	const int BOMB_RADIUS = 10;       // as in Board::TriggerBomb
+}
+
+// One step per tank in a round of all four directions, as the queued moves of a tick apply them
+static void BM_Move(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	int players = static_cast<int>(state.range(1));
+	BenchmarkBoard board(size, 1, players, 0);
+	const char keys[] = { 'w', 'd', 's', 'a' };
+	size_t step = 0;
+
+	for (auto _ : state) {
+		char key = keys[step++ % 4];
+		for (int player = 0; player < players; ++player) {
+			board.Move(BenchmarkBoard::PlayerId(player), key);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * players);
+}
+BENCHMARK(BM_Move)->ArgsProduct({ { 20, 256, 1024 }, { 1, 4 } });
+
+// Bullet integration; every pass is undone by the next so the bullets stay on the board
+static void BM_Update(benchmark::State& state)
+{
+	BenchmarkBoard board(64, 1, 0, static_cast<size_t>(state.range(0)));
+	size_t bullets = board.GetBullets().Size();
+	double deltaTime = TICK_SECONDS;
+
+	for (auto _ : state) {
+		for (size_t bullet = 0; bullet < bullets; ++bullet) {
+			board.Update(deltaTime, bullet);
+		}
+		deltaTime = -deltaTime;
+	}
+
+	state.SetItemsProcessed(state.iterations() * bullets);
+	state.counters["bullets"] = static_cast<double>(bullets);
+}
+BENCHMARK(BM_Update)->Arg(16)->Arg(256)->Arg(1024);
+
+// Blasts on a grid of centres far enough apart that each one hits untouched walls;
+// the map is reloaded, untimed, once every centre has gone off
+static void BM_TriggerBomb(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	BenchmarkBoard board(size, 4, static_cast<int>(state.range(1)), 0);
+	mapgen::Map map = mapgen::Generate(BENCHMARK_SEED, size, size, 4);
+
+	std::vector<std::pair<int, int>> centres;
+	for (int x = BOMB_RADIUS / 2; x < size; x += 2 * BOMB_RADIUS + 1) {
+		for (int y = BOMB_RADIUS / 2; y < size; y += 2 * BOMB_RADIUS + 1) {
+			centres.emplace_back(x, y);
+		}
+	}
+
+	size_t next = 0;
+	board.LoadMap(map);
+	for (auto _ : state) {
+		if (next == centres.size()) {
+			state.PauseTiming();
+			board.LoadMap(map);
+			next = 0;
+			state.ResumeTiming();
+		}
+		board.TriggerBomb(centres[next].first, centres[next].second);
+		++next;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TriggerBomb)->ArgsProduct({ { 32, 256, 1024 }, { 0, 4 } });
+
+// A whole simulation step with nothing moving: inputs, systems, collision lookup and the snapshot
+static void BM_Tick(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	BenchmarkBoard board(size, 1, static_cast<int>(state.range(1)), static_cast<size_t>(state.range(2)));
+
+	for (auto _ : state) {
+		board.Tick(0.0);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.counters["bullets"] = static_cast<double>(board.GetBullets().Size());
+}
+BENCHMARK(BM_Tick)->ArgsProduct({ { 20, 256 }, { 1, 4 }, { 0, 256, 1024 } });
@@ -0,0 +1,47 @@
+#include "BoardFixtures.h"
+#include <string>
+
+namespace {
+	const double BULLET_SPEED = 0.5; // as fired by Board::Shoot
+}
+
+BenchmarkBoard::BenchmarkBoard(int size, int difficulty, int players, size_t bullets)
+	: Board(size, size, difficulty)
+{
+	SetSeed(BENCHMARK_SEED);
+	GenerateBoard();
+	for (int player = 0; player < players; ++player) {
+		InsertPlayer(Player(static_cast<uint8_t>(PlayerId(player)), "player" + std::to_string(player), "", 0, 3, 0));
+	}
+	SpawnBullets(bullets);
+	Tick(0.0);
+}
+
+BulletPool& BenchmarkBoard::Bullets()
+{
+	return m_bullets;
+}
+
+int BenchmarkBoard::PlayerId(int player)
+{
+	return player + 1;
+}
+
+// One bullet per empty, tank-free cell, so the zero-length tick neither moves nor destroys any;
+// small boards get fewer than asked for
+void BenchmarkBoard::SpawnBullets(size_t count)
+{
+	const Direction directions[] = { Direction::UP, Direction::RIGHT, Direction::DOWN, Direction::LEFT };
+	size_t spawned = 0;
+	for (int row = 0; row < m_height && spawned < count; ++row) {
+		for (int col = 0; col < m_width && spawned < count; ++col) {
+			if (GetValue(row, col) != 0 || GetPlayerBasedOnCoord(row, col) != nullptr) {
+				continue;
+			}
+			// Bordered coordinates: x = column + 1, y = row + 1
+			if (m_bullets.Spawn(col + 1, row + 1, directions[spawned % 4], BULLET_SPEED, 0)) {
+				++spawned;
+			}
+		}
+	}
+}
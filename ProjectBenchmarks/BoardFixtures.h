@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "..\ProjectServer\Board.h"
+
+const uint32_t BENCHMARK_SEED = 42;
+
+// Board with generated walls, tanks in the first `players` corners and up to `bullets`
+// bullets parked on distinct empty cells, published with a zero-length tick so its
+// snapshot already holds all of them. Exposes the bullet pool so benchmarks can fill
+// it without waiting out shot cooldowns.
+class BenchmarkBoard : public Board
+{
+public:
+    // Constructor and Destructor
+    BenchmarkBoard(int size, int difficulty, int players, size_t bullets);
+    ~BenchmarkBoard() = default;
+
+    // Getters
+    BulletPool& Bullets();
+
+    static int PlayerId(int player); // ids given to the inserted tanks, 1-based
+
+private:
+    // Helper Functions
+    void SpawnBullets(size_t count);
+};
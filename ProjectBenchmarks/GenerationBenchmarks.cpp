@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "BoardFixtures.h"
+#include "..\ProjectServer\MapGenerator.h"
+#include "..\ProjectServer\ReachabilityValidator.h"
+#include "..\ProjectServer\SolidWallFixer.h"
+
+namespace {
+	const int SOLID_BLOCK_SIZE = 3;
+
+	void MapSizes(benchmark::internal::Benchmark* benchmark)
+	{
+		for (int size : { 20, 64, 256, 1024, 4096 }) {
+			for (int difficulty : { 1, 4 }) {
+				benchmark->Args({ size, difficulty });
+			}
+		}
+	}
+
+	// Cells with the given share of solid walls, the rest split between empty and breakable
+	std::vector<uint8_t> RandomCells(int size, int solidPercent)
+	{
+		std::mt19937 random(BENCHMARK_SEED);
+		std::uniform_int_distribution<int> percent(0, 99);
+		std::vector<uint8_t> cells(static_cast<size_t>(size) * size);
+		for (uint8_t& cell : cells) {
+			int value = percent(random);
+			cell = value < solidPercent ? 2 : value % 2;
+		}
+		return cells;
+	}
+}
+
+// Full regeneration as /changeDifficulty pays for it: random fill, wall fixing and the snapshot
+static void BM_GenerateBoard(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	Board board(size, size, static_cast<int>(state.range(1)));
+	board.SetSeed(BENCHMARK_SEED);
+
+	for (auto _ : state) {
+		board.GenerateBoard();
+	}
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+	state.counters["cells"] = static_cast<double>(size) * size;
+}
+BENCHMARK(BM_GenerateBoard)->Apply(MapSizes)->Unit(benchmark::kMillisecond);
+
+// Swapping in a pooled map, which is all /changeDifficulty and room creation pay on a pool hit
+static void BM_LoadMap(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	int difficulty = static_cast<int>(state.range(1));
+	Board board(size, size, difficulty);
+	mapgen::Map map = mapgen::Generate(BENCHMARK_SEED, size, size, difficulty);
+
+	for (auto _ : state) {
+		board.LoadMap(map);
+	}
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_LoadMap)->Apply(MapSizes)->Unit(benchmark::kMillisecond);
+
+// Only the summed-area-table pass, on boards dense enough to need many fixes
+static void BM_FixSolidWalls(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	std::vector<uint8_t> cells = RandomCells(size, static_cast<int>(state.range(1)));
+	SolidWallFixer fixer(size, size, SOLID_BLOCK_SIZE);
+	size_t fixes = 0;
+
+	for (auto _ : state) {
+		fixes = fixer.Fix(cells).size();
+		benchmark::DoNotOptimize(fixes);
+	}
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+	state.counters["fixes"] = static_cast<double>(fixes);
+}
+BENCHMARK(BM_FixSolidWalls)
+	->ArgsProduct({ { 20, 64, 256, 1024, 4096 }, { 25, 60 } })
+	->Unit(benchmark::kMicrosecond);
+
+// The spawn connectivity check run on every generated layout; items are validations
+static void BM_ValidateReachability(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	mapgen::Map map = mapgen::Generate(BENCHMARK_SEED, size, size, static_cast<int>(state.range(1)));
+	ReachabilityValidator validator(size, size);
+	bool connected = false;
+
+	for (auto _ : state) {
+		connected = validator.SpawnsConnected(map.cells);
+		benchmark::DoNotOptimize(connected);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.counters["cells"] = static_cast<double>(size) * size;
+}
+BENCHMARK(BM_ValidateReachability)->Apply(MapSizes)->Unit(benchmark::kMicrosecond);
+
+// Walled-off spawns: the fill has to exhaust the first corner's region before it can fail
+static void BM_RejectUnreachable(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	std::vector<uint8_t> cells = RandomCells(size, 25);
+	for (int col = 0; col < size; ++col) {
+		cells[static_cast<size_t>(size / 2) * size + col] = 2;
+	}
+	ReachabilityValidator validator(size, size);
+	bool connected = true;
+
+	for (auto _ : state) {
+		connected = validator.SpawnsConnected(cells);
+		benchmark::DoNotOptimize(connected);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RejectUnreachable)->Arg(20)->Arg(64)->Arg(256)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
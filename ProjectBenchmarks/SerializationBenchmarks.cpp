@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "BoardFixtures.h"
+
+// The route bodies main.cpp builds from a snapshot, each up to its dumped JSON text
+
+// Rows of symbols as built for /game; the route caches the dump per version, this is the miss
+static void BM_GetBoardState(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	BenchmarkBoard board(size, 1, 4, 0);
+	std::shared_ptr<const BoardSnapshot> snapshot = board.GetLatestSnapshot();
+	size_t bytes = 0;
+
+	for (auto _ : state) {
+		std::string body = snapshot->GetBoardState().dump();
+		bytes = body.size();
+		benchmark::DoNotOptimize(body);
+	}
+
+	state.SetBytesProcessed(state.iterations() * bytes);
+	state.counters["cells"] = static_cast<double>(size) * size;
+}
+BENCHMARK(BM_GetBoardState)->Arg(20)->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+// The board part of the /join response
+static void BM_GetPlayerState(benchmark::State& state)
+{
+	BenchmarkBoard board(20, 1, static_cast<int>(state.range(0)), 0);
+	std::shared_ptr<const BoardSnapshot> snapshot = board.GetLatestSnapshot();
+
+	for (auto _ : state) {
+		std::string body = snapshot->GetPlayerState().dump();
+		benchmark::DoNotOptimize(body);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetPlayerState)->Arg(1)->Arg(2)->Arg(4);
+
+// /bulletsCoord
+static void BM_GetBulletCoords(benchmark::State& state)
+{
+	BenchmarkBoard board(64, 1, 0, static_cast<size_t>(state.range(0)));
+	std::shared_ptr<const BoardSnapshot> snapshot = board.GetLatestSnapshot();
+
+	for (auto _ : state) {
+		std::string body = snapshot->GetBulletCoords().dump();
+		benchmark::DoNotOptimize(body);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.counters["bullets"] = static_cast<double>(snapshot->GetBullets().size());
+}
+BENCHMARK(BM_GetBulletCoords)->Arg(16)->Arg(256)->Arg(1024);
+
+// /snapshot with every field, the JSON the client falls back to without binary support
+static void BM_GetSnapshot(benchmark::State& state)
+{
+	int size = static_cast<int>(state.range(0));
+	BenchmarkBoard board(size, 1, 4, static_cast<size_t>(state.range(1)));
+	std::shared_ptr<const BoardSnapshot> snapshot = board.GetLatestSnapshot();
+	size_t bytes = 0;
+
+	for (auto _ : state) {
+		std::string body = snapshot->GetSnapshot(SNAPSHOT_ALL, 0).dump();
+		bytes = body.size();
+		benchmark::DoNotOptimize(body);
+	}
+
+	state.SetBytesProcessed(state.iterations() * bytes);
+	state.counters["bullets"] = static_cast<double>(snapshot->GetBullets().size());
+}
+BENCHMARK(BM_GetSnapshot)->ArgsProduct({ { 20, 256 }, { 0, 256, 1024 } })->Unit(benchmark::kMicrosecond);
+
+// /game?since=<version> after the given number of tank moves
+static void BM_GetBoardDelta(benchmark::State& state)
+{
+	int moves = static_cast<int>(state.range(0));
+	BenchmarkBoard board(64, 1, 4, 0);
+	uint64_t since = board.GetStateVersion();
+	const char keys[] = { 'w', 'd', 's', 'a' };
+	for (int move = 0; move < moves; ++move) {
+		board.Move(BenchmarkBoard::PlayerId(move % 4), keys[move / 4 % 4]);
+	}
+
+	for (auto _ : state) {
+		std::string body = board.GetBoardDelta(since).dump();
+		benchmark::DoNotOptimize(body);
+	}
+
+	state.SetItemsProcessed(state.iterations() * moves);
+}
+BENCHMARK(BM_GetBoardDelta)->Arg(8)->Arg(64)->Arg(512);
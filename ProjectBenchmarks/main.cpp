@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BaselineReporter.h"
+
+// Board benchmarks. Run in Release; for machine-readable results add
+//
+//     ProjectBenchmarks --benchmark_out=results.json --benchmark_out_format=json
+//
+// and to fail on regressions against a baseline (exit code 1)
+//
+//     ProjectBenchmarks --baseline=baseline.json [--baseline_tolerance=10]
+//
+// The tolerance is in percent of CPU time. The baseline is the JSON output of an unfiltered
+// Release run on the reference machine; record_baseline.ps1 builds, runs and commits it, and is
+// run again whenever a change is meant to move the numbers. Timings from any other machine or
+// build say nothing about a regression.
+
+const double DEFAULT_TOLERANCE_PERCENT = 10.0;
+
+int main(int argc, char** argv)
+{
+	std::string baselinePath;
+	double tolerancePercent = DEFAULT_TOLERANCE_PERCENT;
+
+	// Our flags are taken out before Google Benchmark sees the rest
+	std::vector<char*> arguments;
+	for (int arg = 0; arg < argc; ++arg) {
+		std::string_view argument = argv[arg];
+		if (argument.starts_with("--baseline=")) {
+			baselinePath = argument.substr(std::string_view("--baseline=").size());
+		}
+		else if (argument.starts_with("--baseline_tolerance=")) {
+			tolerancePercent = std::atof(argv[arg] + std::string_view("--baseline_tolerance=").size());
+		}
+		else {
+			arguments.push_back(argv[arg]);
+		}
+	}
+	int argumentCount = static_cast<int>(arguments.size());
+
+	benchmark::Initialize(&argumentCount, arguments.data());
+	if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data())) {
+		return 1;
+	}
+
+	BaselineReporter reporter;
+	benchmark::RunSpecifiedBenchmarks(&reporter);
+	benchmark::Shutdown();
+
+	if (baselinePath.empty()) {
+		return 0;
+	}
+
+	try {
+		int regressions = baseline::Compare(reporter.GetTimes(), baseline::Load(baselinePath), tolerancePercent / 100.0);
+		return regressions > 0 ? 1 : 0;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,61 @@
+# Records baseline.json for the regression gate from an unfiltered Release run and commits it.
+# Run it on the reference machine, with nothing else busy, from a Developer PowerShell:
+#
+#     .\ProjectBenchmarks\record_baseline.ps1 [-Platform x64] [-Repetitions 3] [-NoCommit]
+#
+# Record again whenever a change is meant to move the numbers, and commit the new baseline
+# together with that change.
+
+param(
+    [ValidateSet("x64", "Win32")]
+    [string]$Platform = "x64",
+    [int]$Repetitions = 3,
+    [switch]$NoCommit
+)
+
+$ErrorActionPreference = "Stop"
+
+$project = Join-Path $PSScriptRoot "ProjectBenchmarks.vcxproj"
+$baseline = Join-Path $PSScriptRoot "baseline.json"
+
+# MSBuild is on the path in a Developer PowerShell; otherwise ask the Visual Studio installer
+$msbuild = (Get-Command msbuild.exe -ErrorAction SilentlyContinue).Source
+if (-not $msbuild) {
+    $vswhere = Join-Path ${env:ProgramFiles(x86)} "Microsoft Visual Studio\Installer\vswhere.exe"
+    if (Test-Path $vswhere) {
+        $msbuild = & $vswhere -latest -requires Microsoft.Component.MSBuild -find "MSBuild\**\Bin\MSBuild.exe" | Select-Object -First 1
+    }
+}
+if (-not $msbuild) {
+    throw "MSBuild not found; run this from a Developer PowerShell"
+}
+
+& $msbuild $project /m /p:Configuration=Release /p:Platform=$Platform /v:minimal
+if ($LASTEXITCODE -ne 0) {
+    throw "Release build failed"
+}
+
+# Built on its own the project is its own solution directory; Win32 output has no platform folder
+$outputDirectory = if ($Platform -eq "Win32") { "Release" } else { "$Platform\Release" }
+$executable = Join-Path $PSScriptRoot "$outputDirectory\ProjectBenchmarks.exe"
+
+& $executable "--benchmark_repetitions=$Repetitions" "--benchmark_out=$baseline" "--benchmark_out_format=json"
+if ($LASTEXITCODE -ne 0) {
+    throw "Benchmark run failed"
+}
+
+$context = (Get-Content $baseline -Raw | ConvertFrom-Json).context
+if ($context.library_build_type -ne "release") {
+    throw "Google Benchmark reports a $($context.library_build_type) library; a baseline must come from a Release build"
+}
+
+if ($NoCommit) {
+    Write-Host "Recorded $baseline"
+    return
+}
+
+git -C $PSScriptRoot add baseline.json
+git -C $PSScriptRoot commit -m "Record benchmark baseline on $($context.host_name) ($($context.num_cpus) CPUs, $Platform Release)" -- baseline.json
+if ($LASTEXITCODE -ne 0) {
+    throw "Committing the baseline failed"
+}
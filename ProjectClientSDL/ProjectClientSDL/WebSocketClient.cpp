@@ -0,0 +1,242 @@
+#include "WebSocketClient.h"
+
+namespace {
+    const uint8_t OPCODE_CONTINUATION = 0x0;
+    const uint8_t OPCODE_TEXT = 0x1;
+    const uint8_t OPCODE_BINARY = 0x2;
+    const uint8_t OPCODE_CLOSE = 0x8;
+    const uint8_t OPCODE_PING = 0x9;
+    const uint8_t OPCODE_PONG = 0xA;
+
+    std::string Base64(const uint8_t* data, size_t length)
+    {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded;
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t chunk = data[i] << 16;
+            if (i + 1 < length) chunk |= data[i + 1] << 8;
+            if (i + 2 < length) chunk |= data[i + 2];
+
+            encoded.push_back(alphabet[(chunk >> 18) & 0x3F]);
+            encoded.push_back(alphabet[(chunk >> 12) & 0x3F]);
+            encoded.push_back(i + 1 < length ? alphabet[(chunk >> 6) & 0x3F] : '=');
+            encoded.push_back(i + 2 < length ? alphabet[chunk & 0x3F] : '=');
+        }
+        return encoded;
+    }
+}
+
+WebSocketClient::WebSocketClient()
+    : m_socket(m_ioContext),
+    m_maskGenerator(std::random_device{}()),
+    m_connected(false)
+{
+}
+
+WebSocketClient::~WebSocketClient()
+{
+    Close();
+    asio::error_code error;
+    m_socket.close(error);
+}
+
+// Opens the TCP connection and performs the upgrade handshake
+bool WebSocketClient::Connect(const std::string& host, const std::string& port, const std::string& path)
+{
+    // A dropped connection leaves its socket open and maybe a partial frame behind
+    asio::error_code error;
+    m_socket.close(error);
+    m_readBuffer.consume(m_readBuffer.size());
+
+    asio::ip::tcp::resolver resolver(m_ioContext);
+    auto endpoints = resolver.resolve(host, port, error);
+    if (error) {
+        return false;
+    }
+    asio::connect(m_socket, endpoints, error);
+    if (error) {
+        return false;
+    }
+
+    uint8_t nonce[16];
+    for (uint8_t& byte : nonce) {
+        byte = static_cast<uint8_t>(m_maskGenerator());
+    }
+
+    std::string request =
+        "GET " + path + " HTTP/1.1\r\n"
+        "Host: " + host + ":" + port + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: " + Base64(nonce, sizeof(nonce)) + "\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n";
+    asio::write(m_socket, asio::buffer(request), error);
+    if (error) {
+        return false;
+    }
+
+    // Anything read past the headers stays in m_readBuffer for the first frame
+    size_t headerLength = asio::read_until(m_socket, m_readBuffer, "\r\n\r\n", error);
+    if (error) {
+        return false;
+    }
+    std::string headers(asio::buffers_begin(m_readBuffer.data()), asio::buffers_begin(m_readBuffer.data()) + headerLength);
+    m_readBuffer.consume(headerLength);
+    if (headers.compare(0, 12, "HTTP/1.1 101") != 0) {
+        m_socket.close(error);
+        return false;
+    }
+
+    m_connected = true;
+    return true;
+}
+
+// Shutting down fails a blocked read on the receiving thread; the descriptor itself is only
+// released by the thread that owns the socket, in Connect or the destructor
+void WebSocketClient::Close()
+{
+    if (m_connected.exchange(false)) {
+        SendFrame(OPCODE_CLOSE, nullptr, 0);
+        asio::error_code error;
+        m_socket.shutdown(asio::ip::tcp::socket::shutdown_both, error);
+    }
+}
+
+bool WebSocketClient::IsConnected() const
+{
+    return m_connected;
+}
+
+bool WebSocketClient::SendText(const std::string& text)
+{
+    return SendFrame(OPCODE_TEXT, text.data(), text.size());
+}
+
+// Blocks until a whole text or binary message arrives; pings are answered here.
+// message keeps its capacity between calls, so steady-state frames do not allocate.
+bool WebSocketClient::Receive(std::string& message, bool& isBinary)
+{
+    message.clear();
+    while (m_connected) {
+        uint8_t header[2];
+        if (!ReadExactly(header, sizeof(header))) {
+            return false;
+        }
+
+        bool final = header[0] & 0x80;
+        uint8_t opcode = header[0] & 0x0F;
+        bool masked = header[1] & 0x80;
+        uint64_t length = header[1] & 0x7F;
+
+        if (length == 126) {
+            uint8_t extended[2];
+            if (!ReadExactly(extended, sizeof(extended))) {
+                return false;
+            }
+            length = (extended[0] << 8) | extended[1];
+        }
+        else if (length == 127) {
+            uint8_t extended[8];
+            if (!ReadExactly(extended, sizeof(extended))) {
+                return false;
+            }
+            length = 0;
+            for (uint8_t byte : extended) {
+                length = (length << 8) | byte;
+            }
+        }
+
+        uint8_t mask[4] = { 0, 0, 0, 0 };
+        if (masked && !ReadExactly(mask, sizeof(mask))) {
+            return false;
+        }
+
+        size_t offset = message.size();
+        message.resize(offset + length);
+        if (!ReadExactly(message.data() + offset, length)) {
+            return false;
+        }
+        if (masked) {
+            for (size_t i = 0; i < length; ++i) {
+                message[offset + i] ^= mask[i % 4];
+            }
+        }
+
+        switch (opcode) {
+        case OPCODE_CLOSE:
+            Close();
+            return false;
+        case OPCODE_PING:
+            SendFrame(OPCODE_PONG, message.data() + offset, length);
+            message.resize(offset);
+            continue;
+        case OPCODE_TEXT:
+        case OPCODE_BINARY:
+            isBinary = opcode == OPCODE_BINARY;
+            break;
+        case OPCODE_CONTINUATION:
+            break;
+        default:
+            message.resize(offset);
+            continue;
+        }
+
+        if (final) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Client frames must be masked (RFC 6455, section 5.3)
+bool WebSocketClient::SendFrame(uint8_t opcode, const char* payload, size_t length)
+{
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+
+    m_sendBuffer.clear();
+    m_sendBuffer.push_back(static_cast<char>(0x80 | opcode));
+    if (length < 126) {
+        m_sendBuffer.push_back(static_cast<char>(0x80 | length));
+    }
+    else if (length <= 0xFFFF) {
+        m_sendBuffer.push_back(static_cast<char>(0x80 | 126));
+        m_sendBuffer.push_back(static_cast<char>(length >> 8));
+        m_sendBuffer.push_back(static_cast<char>(length & 0xFF));
+    }
+    else {
+        m_sendBuffer.push_back(static_cast<char>(0x80 | 127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            m_sendBuffer.push_back(static_cast<char>((static_cast<uint64_t>(length) >> shift) & 0xFF));
+        }
+    }
+
+    uint32_t maskBits = m_maskGenerator();
+    char mask[4];
+    for (int i = 0; i < 4; ++i) {
+        mask[i] = static_cast<char>((maskBits >> (i * 8)) & 0xFF);
+        m_sendBuffer.push_back(mask[i]);
+    }
+    for (size_t i = 0; i < length; ++i) {
+        m_sendBuffer.push_back(payload[i] ^ mask[i % 4]);
+    }
+
+    asio::error_code error;
+    asio::write(m_socket, asio::buffer(m_sendBuffer), error);
+    return !error;
+}
+
+bool WebSocketClient::ReadExactly(void* destination, size_t length)
+{
+    if (m_readBuffer.size() < length) {
+        asio::error_code error;
+        asio::read(m_socket, m_readBuffer, asio::transfer_at_least(length - m_readBuffer.size()), error);
+        if (error) {
+            m_connected = false;
+            return false;
+        }
+    }
+
+    asio::buffer_copy(asio::buffer(destination, length), m_readBuffer.data());
+    m_readBuffer.consume(length);
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <asio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+
+// Minimal blocking RFC 6455 client, just enough for the server's /ws push channel.
+// One thread may sit in Receive while others send or Close; writes are serialized internally.
+// Connect and Receive belong to one thread, which may Connect again after the channel drops.
+class WebSocketClient
+{
+private:
+    // Member Variables
+    asio::io_context m_ioContext;
+    asio::ip::tcp::socket m_socket;
+    asio::streambuf m_readBuffer;
+    std::mutex m_sendMutex;
+    std::string m_sendBuffer;
+    std::mt19937 m_maskGenerator;
+    std::atomic<bool> m_connected;
+
+public:
+    // Constructor and Destructor
+    WebSocketClient();
+    ~WebSocketClient();
+
+    // Connection
+    bool Connect(const std::string& host, const std::string& port, const std::string& path);
+    void Close(); // only shuts the socket down, so it is safe while another thread is in Receive
+    bool IsConnected() const;
+
+    // Messaging
+    bool SendText(const std::string& text);
+    bool Receive(std::string& message, bool& isBinary);
+
+private:
+    // Helper Functions
+    bool SendFrame(uint8_t opcode, const char* payload, size_t length);
+    bool ReadExactly(void* destination, size_t length);
+};
@@ -4,6 +4,9 @@
 const int GRID_ROWS = 10;
 const int GRID_COLS = 10;
 
+// Push channel settings
+const auto PUSH_RETRY_INTERVAL = std::chrono::seconds(5); // while polling, how often the WebSocket is tried again
+
 Window::Window(const char* title, int width, int height)
     : m_window(nullptr),
     renderer(nullptr),
@@ -76,15 +79,20 @@ Window::~Window() {
 
 void Window::Run() {
     std::thread pollingThread([&]() {
+        // Frames are pushed every tick when the WebSocket channel is up; while it is down, or after
+        // it drops, the board is polled and the channel is retried now and then
+        auto nextAttempt = std::chrono::steady_clock::now();
         while (m_running) {
-            auto response = cpr::Get(cpr::Url{ "http://localhost:18080/game" });
-            if (response.status_code == 200) {
-                UpdateBoard();
-                Render();
+            if (std::chrono::steady_clock::now() >= nextAttempt) {
+                nextAttempt = std::chrono::steady_clock::now() + PUSH_RETRY_INTERVAL;
+                if (ConnectPushChannel()) {
+                    ReceiveFrames();
+                    continue;
+                }
             }
-            else {
-                std::cerr << "Error: Failed to fetch board state. Status code: "
-                    << response.status_code << std::endl;
+
+            if (UpdateBoard()) {
+                Render();
             }
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
@@ -114,6 +122,7 @@ void Window::Run() {
     }
 
     // Cleanup resources
+    m_pushChannel.Close(); // shuts the socket down, which unblocks the receiving thread
     if (pollingThread.joinable()) {
         pollingThread.join(); // Ensure the polling thread is joined
     }
@@ -130,13 +139,20 @@ void Window::Run() {
 }
 
 void Window::Render() {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    if (m_board.empty()) {
+        return;
+    }
+
     Clear(); // Clear the window
 
     int cellWidth = m_width / m_board[0].size();
     int cellHeight = m_height / m_board.size();
-    auto response = cpr::Get(cpr::Url{ "http://localhost:18080/bulletsCoord" });
-    auto coord = crow::json::load(response.text);
-    auto bulletsCoord = coord["bullets"];
+    // Bullets come from the same frame as the board, so both show the same tick
+    wire::MessageView bullets;
+    if (!bullets.Parse(m_frame)) {
+        bullets = wire::MessageView{};
+    }
     SDL_Texture* bullet = m_textures[71];
 
     std::map<std::pair<int, int>, SDL_Texture*> tankTextureMap;
@@ -190,8 +206,9 @@ void Window::Render() {
     }
 
     // Render bullets
-    for (auto bulletCoord : bulletsCoord) {
-        SDL_Rect pos = { bulletCoord["coordX"].d() * cellWidth, bulletCoord["coordY"].d() * cellHeight, cellWidth, cellHeight };
+    for (size_t i = 0; i < bullets.GetHeader().bulletCount; ++i) {
+        wire::BulletRecord record = bullets.BulletAt(i);
+        SDL_Rect pos = { static_cast<int>(record.x * cellWidth), static_cast<int>(record.y * cellHeight), cellWidth, cellHeight };
         SDL_RenderCopy(renderer, bullet, NULL, &pos);
     }
     SDL_RenderPresent(renderer);
@@ -296,29 +313,108 @@ SDL_Texture* Window::GetTileTextureBasedOnBoardValue(int boardValue)
     return nullptr;
 }
 
-void Window::UpdateBoard()
+// Fetches board, tanks and bullets in one snapshot so they are taken at the same tick
+bool Window::UpdateBoard()
 {
-    auto response = cpr::Get(cpr::Url{ "http://localhost:18080/game" });
-    const auto& board = crow::json::load(response.text);
+    auto response = cpr::Get(cpr::Url{ "http://localhost:18080/snapshot" },
+        cpr::Parameters{ { "fields", "board,tanks,bullets" } },
+        cpr::Header{ { "Accept", wire::CONTENT_TYPE } });
     if (response.status_code != 200) {
         std::cerr << "Error: HTTP request failed with status code " << response.status_code << std::endl;
+        return false;
     }
-    if (!board) {
-        std::cerr << "Error: Failed to parse JSON response." << std::endl;
-    }
-    std::vector<std::vector<int>> auxBoard;
-    if (board.has("board")) {
-        const auto& matrix = board["board"];
-        for (size_t i = 0; i < matrix.size(); ++i) {
-            const auto& row = matrix[i];
-            std::vector<int> vec;
-            for (size_t j = 0; j < row.size(); ++j) {
-                vec.push_back(row[j].i());
+
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    wire::MessageView message;
+    if (!message.Parse(response.text)) {
+        std::cerr << "Error: Failed to parse board state." << std::endl;
+        return false;
+    }
+    m_frame.swap(response.text);
+    message.Parse(m_frame);
+    ApplyState(message);
+    return true;
+}
+
+void Window::ApplyState(const wire::MessageView& message)
+{
+    // The board keeps its border, so it is two cells larger than the map in each direction
+    const wire::Header& header = message.GetHeader();
+    size_t rows = header.height + 2;
+    size_t cols = header.width + 2;
+    if (m_board.size() != rows || m_board[0].size() != cols) {
+        m_board.assign(rows, std::vector<int>(cols, '#'));
+    }
+
+    for (int row = 0; row < header.height; ++row) {
+        std::vector<int>& boardRow = m_board[row + 1];
+        for (int col = 0; col < header.width; ++col) {
+            switch (message.CellAt(row, col)) {
+            case wire::Cell::Breakable:
+                boardRow[col + 1] = '+';
+                break;
+            case wire::Cell::Solid:
+                boardRow[col + 1] = '#';
+                break;
+            default:
+                boardRow[col + 1] = ' ';
+                break;
             }
-            auxBoard.push_back(vec);
         }
     }
-    m_board = auxBoard;
+
+    for (size_t tank = 0; tank < header.tankCount; ++tank) {
+        wire::TankRecord record = message.TankAt(tank);
+        if (record.alive && record.x < header.height && record.y < header.width) {
+            m_board[record.x + 1][record.y + 1] = 'P';
+        }
+    }
+}
+
+bool Window::ConnectPushChannel()
+{
+    if (!m_pushChannel.Connect("localhost", "18080", "/ws")) {
+        std::cerr << "Push channel unavailable, falling back to polling." << std::endl;
+        return false;
+    }
+
+    crow::json::wvalue subscribe;
+    subscribe["type"] = "subscribe";
+    subscribe["room"] = 0;
+    subscribe["player"] = m_playerId;
+    if (!m_pushChannel.SendText(subscribe.dump())) {
+        m_pushChannel.Close();
+        return false;
+    }
+    return true;
+}
+
+// Runs on the polling thread: every binary message is a full frame for one tick
+void Window::ReceiveFrames()
+{
+    bool isBinary = false;
+    while (m_running && m_pushChannel.Receive(m_frameBuffer, isBinary)) {
+        if (!isBinary) {
+            std::cerr << "Server: " << m_frameBuffer << std::endl;
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            wire::MessageView message;
+            if (!message.Parse(m_frameBuffer)) {
+                continue;
+            }
+            m_frame.swap(m_frameBuffer);
+            message.Parse(m_frame);
+            ApplyState(message);
+        }
+        Render();
+    }
+
+    if (m_running) {
+        std::cerr << "Push channel lost, falling back to polling." << std::endl;
+    }
 }
 
 void Window::GetTime()
@@ -336,6 +432,14 @@ void Window::GetTime()
 
 void Window::PlayerAction(int playerId, std::string action)
 {
+    if (m_pushChannel.IsConnected()) {
+        crow::json::wvalue input;
+        input["type"] = "input";
+        input["key"] = action;
+        m_pushChannel.SendText(input.dump());
+        return;
+    }
+
     // Send the move command to the server
     auto response = cpr::Get(cpr::Url{ "http://localhost:18080/action/" + std::to_string(playerId) + "/" + action });
 }
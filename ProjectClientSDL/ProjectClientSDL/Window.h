@@ -10,6 +10,9 @@
 #include <conio.h>
 #include <limits>
 #include <map>
+#include <mutex>
+#include "WebSocketClient.h"
+#include "..\..\ProjectServer\WireFormat.h"
 
 class Window
 {
@@ -24,6 +27,12 @@ private:
     std::map<int, SDL_Texture*> m_textures;
     std::map<int, std::vector<SDL_Texture*>> m_multiTextures;
 
+    // Push channel
+    WebSocketClient m_pushChannel;
+    std::mutex m_stateMutex;   // guards m_board and m_frame
+    std::string m_frame;       // last frame pushed by the server
+    std::string m_frameBuffer; // receive buffer, swapped with m_frame
+
 public:
     // Constructor and Destructor
     Window(const char* title, int width, int height);
@@ -39,7 +48,10 @@ public:
     SDL_Texture* GetTileTextureBasedOnBoardValue(int boardValue);
 
     // Game Logic
-    void UpdateBoard();
+    bool UpdateBoard();
+    void ApplyState(const wire::MessageView& message);
+    bool ConnectPushChannel();
+    void ReceiveFrames();
     void PlayerAction(int playerId, std::string action);
 
     // Utility
@@ -0,0 +1,190 @@
+#include "LoadWorker.h"
+#include <algorithm>
+#include <crow.h>
+#include <functional>
+#include <queue>
+#include <thread>
+
+namespace {
+	const char* MOVE_KEYS = "wasd";
+	const char* SHOOT_KEY = "f";
+	const char* PASSWORD = "load";
+}
+
+void RouteStats::Merge(const RouteStats& other)
+{
+	latency.Merge(other.latency);
+	requests += other.requests;
+	errors += other.errors;
+	for (const auto& [status, count] : other.statuses) {
+		statuses[status] += count;
+	}
+}
+
+LoadWorker::LoadWorker(const LoadOptions& options, std::vector<VirtualPlayer> players, uint32_t seed)
+	: m_options(options),
+	m_players(std::move(players)),
+	m_random(seed)
+{
+}
+
+void LoadWorker::JoinAll()
+{
+	for (VirtualPlayer& player : m_players) {
+		Join(player);
+	}
+}
+
+// Every joined player gets its own Poisson stream of moves, shots and polls
+void LoadWorker::Run(Clock::time_point end)
+{
+	std::priority_queue<Due, std::vector<Due>, std::greater<Due>> schedule;
+	Clock::time_point start = Clock::now();
+
+	auto plan = [&](Clock::time_point from, size_t player, Route route) {
+		double rate = route == Route::Move ? m_options.moveRate : route == Route::Shoot ? m_options.shootRate : m_options.pollRate;
+		if (rate > 0.0) {
+			schedule.push({ from + NextInterval(rate), player, route });
+		}
+		};
+
+	for (size_t player = 0; player < m_players.size(); ++player) {
+		if (m_players[player].playerId < 0) {
+			continue;
+		}
+		plan(start, player, Route::Move);
+		plan(start, player, Route::Shoot);
+		plan(start, player, Route::Game);
+	}
+
+	std::uniform_int_distribution<int> moveKey(0, 3);
+	while (!schedule.empty() && schedule.top().time < end) {
+		Due due = schedule.top();
+		schedule.pop();
+
+		std::this_thread::sleep_until(due.time);
+		m_lag.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - due.time).count()));
+
+		VirtualPlayer& player = m_players[due.player];
+		switch (due.route) {
+		case Route::Move:
+			Act(player, std::string(1, MOVE_KEYS[moveKey(m_random)]), Route::Move, due.time);
+			break;
+		case Route::Shoot:
+			Act(player, SHOOT_KEY, Route::Shoot, due.time);
+			break;
+		default:
+			PollGame(player, due.time);
+			break;
+		}
+		plan(due.time, due.player, due.route);
+	}
+}
+
+const std::array<RouteStats, ROUTE_COUNT>& LoadWorker::GetStats() const
+{
+	return m_stats;
+}
+
+const LatencyHistogram& LoadWorker::GetLag() const
+{
+	return m_lag;
+}
+
+size_t LoadWorker::GetJoinedCount() const
+{
+	return std::count_if(m_players.begin(), m_players.end(), [](const VirtualPlayer& player) {
+		return player.playerId >= 0;
+		});
+}
+
+const char* LoadWorker::RouteName(Route route)
+{
+	switch (route) {
+	case Route::CreateRoom:
+		return "POST /room";
+	case Route::Join:
+		return "POST /join";
+	case Route::Move:
+		return "GET /action (move)";
+	case Route::Shoot:
+		return "GET /action (shoot)";
+	case Route::Game:
+		return "GET /game";
+	case Route::CloseRoom:
+		return "DELETE /room";
+	default:
+		return "?";
+	}
+}
+
+// Same request as MenuWindow::JoinGame; the session is kept for the body-less GETs that follow
+void LoadWorker::Join(VirtualPlayer& player)
+{
+	crow::json::wvalue joinRequest;
+	joinRequest["playerName"] = m_options.namePrefix + "-" + std::to_string(player.index);
+	joinRequest["password"] = PASSWORD;
+
+	Clock::time_point scheduled = Clock::now();
+	cpr::Response response = cpr::Post(
+		cpr::Url{ RoomUrl(player.roomId) + "/join" },
+		cpr::Body{ joinRequest.dump() },
+		cpr::Header{ {"Content-Type", "application/json"} }
+	);
+
+	bool joined = false;
+	if (response.status_code == 200) {
+		auto jsonResponse = crow::json::load(response.text);
+		if (jsonResponse && jsonResponse.has("playerId")) {
+			player.playerId = static_cast<int>(jsonResponse["playerId"].i());
+			joined = true;
+		}
+	}
+	Record(Route::Join, response, scheduled, joined);
+}
+
+// Same request as Window::PlayerAction over HTTP; the server queues it and answers 202
+void LoadWorker::Act(VirtualPlayer& player, const std::string& key, Route route, Clock::time_point scheduled)
+{
+	m_session.SetUrl(cpr::Url{ RoomUrl(player.roomId) + "/action/" + std::to_string(player.playerId) + "/" + key });
+	m_session.SetHeader(cpr::Header{});
+	cpr::Response response = m_session.Get();
+	Record(route, response, scheduled, response.status_code == 202);
+}
+
+// Conditional poll, so an unchanged board costs the server neither a serialization nor a body
+void LoadWorker::PollGame(VirtualPlayer& player, Clock::time_point scheduled)
+{
+	m_session.SetUrl(cpr::Url{ RoomUrl(player.roomId) + "/game" });
+	m_session.SetHeader(player.gameTag.empty() ? cpr::Header{} : cpr::Header{ { "If-None-Match", player.gameTag } });
+	cpr::Response response = m_session.Get();
+
+	if (response.status_code == 200) {
+		auto tag = response.header.find("ETag");
+		player.gameTag = tag != response.header.end() ? tag->second : std::string();
+	}
+	Record(Route::Game, response, scheduled, response.status_code == 200 || response.status_code == 304);
+}
+
+// Exponential gaps make each player's requests a Poisson process, so workers do not fire in lockstep
+LoadWorker::Clock::duration LoadWorker::NextInterval(double rate)
+{
+	std::exponential_distribution<double> gap(rate);
+	return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(m_random)));
+}
+
+void LoadWorker::Record(Route route, const cpr::Response& response, Clock::time_point scheduled, bool expected)
+{
+	RouteStats& stats = m_stats[static_cast<size_t>(route)];
+	stats.latency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - scheduled).count()));
+	++stats.requests;
+	++stats.statuses[response.status_code];
+	if (!expected) {
+		++stats.errors;
+	}
+}
+
+std::string LoadWorker::RoomUrl(int roomId) const
+{
+	return m_options.server + "/room/" + std::to_string(roomId);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cpr/cpr.h>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "..\ProjectServer\LatencyHistogram.h"
+
+struct LoadOptions {
+    std::string server = "http://localhost:18080";
+    int players = 100;
+    int playersPerRoom = 4;   // a room holds at most four tanks
+    int roomId = -1;          // join this existing room instead of creating rooms
+    int threads = 16;
+    double moveRate = 5.0;    // per player per second; 0 disables
+    double shootRate = 1.0;
+    double pollRate = 10.0;
+    double duration = 30.0;   // seconds of steady load after everyone joined
+    int height = 0;           // 0 keeps the server's default board size
+    int width = 0;
+    int difficulty = 1;
+    std::string namePrefix = "load";
+    bool keepRooms = false;
+    uint32_t seed = 1;
+};
+
+enum class Route : uint8_t {
+    CreateRoom,
+    Join,
+    Move,
+    Shoot,
+    Game,
+    CloseRoom
+};
+
+const size_t ROUTE_COUNT = 6;
+
+struct RouteStats {
+    LatencyHistogram latency;          // scheduled send to response, microseconds
+    uint64_t requests = 0;
+    uint64_t errors = 0;               // unexpected status or no response at all
+    std::map<long, uint64_t> statuses; // status code 0 is a transport error
+
+    void Merge(const RouteStats& other);
+};
+
+struct VirtualPlayer {
+    int index = 0;
+    int roomId = 0;
+    int playerId = -1; // -1 until the join succeeded
+    std::string gameTag; // last ETag of /game, sent back as If-None-Match
+};
+
+// Drives a share of the virtual players from one thread over one kept-alive
+// connection. Requests are sent when they are due, not when the previous one
+// returned: latencies are measured from the scheduled time, so a slow server
+// shows up as latency instead of silently lowering the request rate.
+class LoadWorker
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Due {
+        Clock::time_point time;
+        size_t player;
+        Route route;
+
+        bool operator>(const Due& other) const { return time > other.time; }
+    };
+
+    // Member Variables
+    const LoadOptions& m_options;
+    std::vector<VirtualPlayer> m_players;
+    std::mt19937 m_random;
+    cpr::Session m_session; // kept alive across this worker's GETs
+    std::array<RouteStats, ROUTE_COUNT> m_stats;
+    LatencyHistogram m_lag; // how late requests went out; high values mean the generator is the bottleneck
+
+public:
+    // Constructor and Destructor
+    LoadWorker(const LoadOptions& options, std::vector<VirtualPlayer> players, uint32_t seed);
+    ~LoadWorker() = default;
+
+    // Phases
+    void JoinAll();
+    void Run(Clock::time_point end);
+
+    // Getters
+    const std::array<RouteStats, ROUTE_COUNT>& GetStats() const;
+    const LatencyHistogram& GetLag() const;
+    size_t GetJoinedCount() const;
+
+    static const char* RouteName(Route route);
+
+private:
+    // Helper Functions
+    void Join(VirtualPlayer& player);
+    void Act(VirtualPlayer& player, const std::string& key, Route route, Clock::time_point scheduled);
+    void PollGame(VirtualPlayer& player, Clock::time_point scheduled);
+    Clock::duration NextInterval(double rate);
+    void Record(Route route, const cpr::Response& response, Clock::time_point scheduled, bool expected);
+    std::string RoomUrl(int roomId) const;
+};
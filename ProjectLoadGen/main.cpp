@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <chrono>
+#include <cpr/cpr.h>
+#include <crow.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "LoadWorker.h"
+
+// Headless load generator for a local server: N virtual players join, then move,
+// shoot and poll /game at the given rates, and the latency percentiles, error
+// rates and throughput of every route are printed at the end.
+//
+//     ProjectLoadGen [--players 1000] [--threads 16] [--duration 30]
+//                    [--move-rate 5] [--shoot-rate 1] [--poll-rate 10]
+//                    [--players-per-room 4] [--room <id>] [--size <h>x<w>]
+//                    [--difficulty 1] [--server http://localhost:18080]
+//                    [--name-prefix load] [--seed 1] [--keep-rooms]
+//
+// Without --room the players are spread over freshly created rooms, which are
+// closed again at the end unless --keep-rooms is given.
+
+using Clock = std::chrono::steady_clock;
+
+void PrintUsage()
+{
+	std::cerr << "Usage: ProjectLoadGen [--players N] [--threads N] [--duration s] [--move-rate r] [--shoot-rate r]\n"
+		<< "                      [--poll-rate r] [--players-per-room N] [--room id] [--size HxW] [--difficulty d]\n"
+		<< "                      [--server url] [--name-prefix text] [--seed n] [--keep-rooms]" << std::endl;
+}
+
+bool ParseOptions(int argc, char* argv[], LoadOptions& options)
+{
+	for (int arg = 1; arg < argc; ++arg) {
+		std::string_view name = argv[arg];
+		if (name == "--keep-rooms") {
+			options.keepRooms = true;
+			continue;
+		}
+		if (arg + 1 >= argc) {
+			return false;
+		}
+
+		const char* value = argv[++arg];
+		if (name == "--players") options.players = std::atoi(value);
+		else if (name == "--threads") options.threads = std::atoi(value);
+		else if (name == "--duration") options.duration = std::atof(value);
+		else if (name == "--move-rate") options.moveRate = std::atof(value);
+		else if (name == "--shoot-rate") options.shootRate = std::atof(value);
+		else if (name == "--poll-rate") options.pollRate = std::atof(value);
+		else if (name == "--players-per-room") options.playersPerRoom = std::atoi(value);
+		else if (name == "--room") options.roomId = std::atoi(value);
+		else if (name == "--difficulty") options.difficulty = std::atoi(value);
+		else if (name == "--server") options.server = value;
+		else if (name == "--name-prefix") options.namePrefix = value;
+		else if (name == "--seed") options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+		else if (name == "--size") {
+			char* rest = nullptr;
+			options.height = static_cast<int>(std::strtol(value, &rest, 10));
+			options.width = *rest == 'x' ? static_cast<int>(std::strtol(rest + 1, nullptr, 10)) : 0;
+			if (options.height <= 0 || options.width <= 0) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+	}
+
+	return options.players > 0 && options.threads > 0 && options.duration > 0.0
+		&& options.playersPerRoom >= 1 && options.playersPerRoom <= 4
+		&& options.moveRate >= 0.0 && options.shootRate >= 0.0 && options.pollRate >= 0.0;
+}
+
+uint64_t MicrosSince(Clock::time_point start)
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+// One room per playersPerRoom players; returns the ids in creation order, or none on failure
+std::vector<int> CreateRooms(const LoadOptions& options, int count, RouteStats& stats)
+{
+	crow::json::wvalue roomRequest;
+	if (options.height > 0) {
+		roomRequest["height"] = options.height;
+		roomRequest["width"] = options.width;
+	}
+	roomRequest["difficulty"] = options.difficulty;
+	std::string body = roomRequest.dump();
+
+	std::vector<int> roomIds;
+	for (int room = 0; room < count; ++room) {
+		Clock::time_point start = Clock::now();
+		auto response = cpr::Post(cpr::Url{ options.server + "/room" },
+			cpr::Body{ body },
+			cpr::Header{ { "Content-Type", "application/json" } });
+		stats.latency.Record(MicrosSince(start));
+		++stats.requests;
+		++stats.statuses[response.status_code];
+
+		auto jsonResponse = crow::json::load(response.text);
+		if (response.status_code != 201 || !jsonResponse || !jsonResponse.has("roomId")) {
+			++stats.errors;
+			std::cerr << "Error: could not create room " << room << " (status " << response.status_code << "): " << response.text << std::endl;
+			return {};
+		}
+		roomIds.push_back(static_cast<int>(jsonResponse["roomId"].i()));
+	}
+	return roomIds;
+}
+
+void CloseRooms(const LoadOptions& options, const std::vector<int>& roomIds, RouteStats& stats)
+{
+	for (int roomId : roomIds) {
+		Clock::time_point start = Clock::now();
+		auto response = cpr::Delete(cpr::Url{ options.server + "/room/" + std::to_string(roomId) });
+		stats.latency.Record(MicrosSince(start));
+		++stats.requests;
+		++stats.statuses[response.status_code];
+		if (response.status_code != 200) {
+			++stats.errors;
+		}
+	}
+}
+
+void PrintReport(const std::array<RouteStats, ROUTE_COUNT>& stats, const LatencyHistogram& lag, double seconds)
+{
+	auto millis = [](uint64_t micros) {
+		return static_cast<double>(micros) / 1000.0;
+		};
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << std::left << std::setw(22) << "route" << std::right
+		<< std::setw(10) << "requests" << std::setw(9) << "errors" << std::setw(8) << "err%"
+		<< std::setw(10) << "req/s" << std::setw(9) << "p50 ms" << std::setw(9) << "p99 ms"
+		<< std::setw(10) << "p999 ms" << std::setw(10) << "max ms" << std::endl;
+
+	uint64_t totalRequests = 0;
+	uint64_t totalErrors = 0;
+	for (size_t route = 0; route < ROUTE_COUNT; ++route) {
+		const RouteStats& routeStats = stats[route];
+		if (routeStats.requests == 0) {
+			continue;
+		}
+
+		bool steady = route != static_cast<size_t>(Route::CreateRoom) && route != static_cast<size_t>(Route::Join)
+			&& route != static_cast<size_t>(Route::CloseRoom);
+		std::cout << std::left << std::setw(22) << LoadWorker::RouteName(static_cast<Route>(route)) << std::right
+			<< std::setw(10) << routeStats.requests << std::setw(9) << routeStats.errors
+			<< std::setw(8) << 100.0 * routeStats.errors / routeStats.requests;
+		if (steady) {
+			std::cout << std::setw(10) << routeStats.requests / seconds;
+			totalRequests += routeStats.requests;
+			totalErrors += routeStats.errors;
+		}
+		else {
+			std::cout << std::setw(10) << "-";
+		}
+		std::cout << std::setw(9) << millis(routeStats.latency.GetPercentile(50.0))
+			<< std::setw(9) << millis(routeStats.latency.GetPercentile(99.0))
+			<< std::setw(10) << millis(routeStats.latency.GetPercentile(99.9))
+			<< std::setw(10) << millis(routeStats.latency.GetMax()) << std::endl;
+
+		if (routeStats.errors > 0) {
+			std::cout << "    statuses:";
+			for (const auto& [status, count] : routeStats.statuses) {
+				std::cout << " " << (status == 0 ? std::string("no response") : std::to_string(status)) << " x" << count;
+			}
+			std::cout << std::endl;
+		}
+	}
+
+	std::cout << "steady state: " << totalRequests / seconds << " req/s over " << seconds << " s, "
+		<< (totalRequests ? 100.0 * totalErrors / totalRequests : 0.0) << "% errors" << std::endl;
+	std::cout << "send lag: p99 " << millis(lag.GetPercentile(99.0)) << " ms, max " << millis(lag.GetMax())
+		<< " ms (large values mean the generator, not the server, limited the rate; add --threads)" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	LoadOptions options;
+	if (!ParseOptions(argc, argv, options)) {
+		PrintUsage();
+		return 1;
+	}
+
+	std::array<RouteStats, ROUTE_COUNT> stats;
+	RouteStats& createStats = stats[static_cast<size_t>(Route::CreateRoom)];
+
+	std::vector<int> createdRooms;
+	if (options.roomId < 0) {
+		createdRooms = CreateRooms(options, (options.players + options.playersPerRoom - 1) / options.playersPerRoom, createStats);
+		if (createdRooms.empty()) {
+			return 1;
+		}
+	}
+
+	// Players are dealt round robin to the workers, so each room's players are spread over threads
+	int threadCount = std::min(options.threads, options.players);
+	std::vector<std::vector<VirtualPlayer>> shares(threadCount);
+	for (int index = 0; index < options.players; ++index) {
+		VirtualPlayer player;
+		player.index = index;
+		player.roomId = options.roomId >= 0 ? options.roomId : createdRooms[index / options.playersPerRoom];
+		shares[index % threadCount].push_back(std::move(player));
+	}
+
+	std::vector<std::unique_ptr<LoadWorker>> workers;
+	for (int thread = 0; thread < threadCount; ++thread) {
+		workers.push_back(std::make_unique<LoadWorker>(options, std::move(shares[thread]), options.seed + thread));
+	}
+
+	auto runAll = [&workers](auto phase) {
+		std::vector<std::thread> threads;
+		for (auto& worker : workers) {
+			threads.emplace_back([&worker, &phase]() { phase(*worker); });
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		};
+
+	std::cout << "Joining " << options.players << " players in "
+		<< (options.roomId >= 0 ? std::string("room ") + std::to_string(options.roomId) : std::to_string(createdRooms.size()) + " rooms")
+		<< " with " << threadCount << " threads..." << std::endl;
+	runAll([](LoadWorker& worker) { worker.JoinAll(); });
+
+	size_t joined = 0;
+	for (const auto& worker : workers) {
+		joined += worker->GetJoinedCount();
+	}
+	std::cout << joined << " of " << options.players << " players joined; running for " << options.duration << " s..." << std::endl;
+
+	Clock::time_point start = Clock::now();
+	Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+	if (joined > 0) {
+		runAll([end](LoadWorker& worker) { worker.Run(end); });
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	LatencyHistogram lag;
+	for (const auto& worker : workers) {
+		for (size_t route = 0; route < ROUTE_COUNT; ++route) {
+			stats[route].Merge(worker->GetStats()[route]);
+		}
+		lag.Merge(worker->GetLag());
+	}
+
+	if (!options.keepRooms) {
+		CloseRooms(options, createdRooms, stats[static_cast<size_t>(Route::CloseRoom)]);
+	}
+
+	PrintReport(stats, lag, seconds);
+	return joined > 0 ? 0 : 1;
+}
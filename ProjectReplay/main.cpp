@@ -0,0 +1,185 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "..\ProjectServer\Board.h"
+#include "..\ProjectServer\Replay.h"
+
+// Re-simulates a room recorded by the server (BATTLECITY_REPLAY_DIR) as fast as the
+// board allows and reports throughput and where the tick time goes.
+//
+//     ProjectReplay <file.replay> [repetitions]
+
+using Clock = std::chrono::steady_clock;
+
+struct ReplayTimings {
+	uint64_t ticks = 0;
+	uint64_t inputs = 0;
+	uint64_t generations = 0;
+	int64_t total = 0;      // nanoseconds, whole run
+	int64_t inputTime = 0;  // nanoseconds spent in Move, Shoot and InsertPlayer
+	int64_t generationTime = 0;
+	TickPhaseTimes phases;  // summed over every tick
+	uint64_t stateHash = 0;
+};
+
+int64_t Elapsed(Clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// FNV-1a over the cells and tank positions, to check that a change did not alter the game
+uint64_t HashState(Board& board)
+{
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](uint64_t value) {
+		hash ^= value;
+		hash *= 1099511628211ull;
+		};
+
+	for (uint8_t cell : board.GetBoard().cells) {
+		mix(cell);
+	}
+	const TankPool& tanks = board.GetTanks();
+	for (size_t slot = 0; slot < tanks.Size(); ++slot) {
+		mix(static_cast<uint64_t>(tanks.GetRow(slot)));
+		mix(static_cast<uint64_t>(tanks.GetCol(slot)));
+		mix(static_cast<uint64_t>(tanks.GetDirection(slot)));
+	}
+	mix(board.GetBullets().Size());
+	return hash;
+}
+
+ReplayTimings Run(const replay::Header& header, const std::vector<replay::Event>& events)
+{
+	ReplayTimings timings;
+	Board board(header.height, header.width, header.difficulty);
+	board.SetSeed(header.seed);
+	const double deltaTime = 1.0 / header.ticksPerSecond;
+
+	auto advanceTo = [&](uint64_t tick) {
+		while (board.GetTickCount() < tick) {
+			board.Tick(deltaTime);
+			const TickPhaseTimes& phases = board.GetLastTickPhases();
+			timings.phases.inputs += phases.inputs;
+			timings.phases.players += phases.players;
+			timings.phases.bullets += phases.bullets;
+			timings.phases.collisions += phases.collisions;
+			timings.phases.cleanup += phases.cleanup;
+			timings.phases.publish += phases.publish;
+			++timings.ticks;
+		}
+		};
+
+	auto runStart = Clock::now();
+	for (const replay::Event& event : events) {
+		advanceTo(event.tick);
+
+		auto eventStart = Clock::now();
+		switch (event.type) {
+		case replay::EventType::Generate:
+			board.SetDifficultyAsValue(event.value);
+			board.GenerateBoard();
+			timings.generationTime += Elapsed(eventStart);
+			++timings.generations;
+			break;
+		case replay::EventType::LoadMap:
+			board.LoadMap(mapgen::Generate(event.argument, header.height, header.width, event.value));
+			timings.generationTime += Elapsed(eventStart);
+			++timings.generations;
+			break;
+		case replay::EventType::Join:
+			board.InsertPlayer(Player(static_cast<int>(event.argument), "player" + std::to_string(event.argument), "", 0, event.value, 0));
+			timings.inputTime += Elapsed(eventStart);
+			++timings.inputs;
+			break;
+		case replay::EventType::Move:
+			board.Move(static_cast<int>(event.argument), static_cast<char>(event.value));
+			timings.inputTime += Elapsed(eventStart);
+			++timings.inputs;
+			break;
+		case replay::EventType::Shoot:
+			board.Shoot(static_cast<int>(event.argument));
+			timings.inputTime += Elapsed(eventStart);
+			++timings.inputs;
+			break;
+		case replay::EventType::Checkpoint:
+			break;
+		default:
+			throw std::runtime_error("Unknown replay event type " + std::to_string(static_cast<int>(event.type)));
+		}
+	}
+	timings.total = Elapsed(runStart);
+	timings.stateHash = HashState(board);
+	return timings;
+}
+
+void PrintPhase(const char* name, int64_t phase, const ReplayTimings& timings)
+{
+	double perTick = timings.ticks ? static_cast<double>(phase) / timings.ticks / 1000.0 : 0.0;
+	double share = timings.total ? 100.0 * phase / timings.total : 0.0;
+	std::cout << "  " << std::left << std::setw(12) << name << std::right
+		<< std::setw(10) << perTick << " us/tick" << std::setw(8) << share << " %\n";
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		std::cerr << "Usage: ProjectReplay <file.replay> [repetitions]\n";
+		return 1;
+	}
+	int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1;
+
+	try {
+		// Everything is read up front so file I/O is not part of the measurement
+		ReplayReader reader(argv[1]);
+		replay::Header header = reader.GetHeader();
+		std::vector<replay::Event> events;
+		replay::Event event;
+		while (reader.Next(event)) {
+			events.push_back(event);
+		}
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "Replay " << argv[1] << ": " << header.height << "x" << header.width
+			<< ", difficulty " << static_cast<int>(header.difficulty) << ", seed " << header.seed
+			<< ", " << header.ticksPerSecond << " ticks/s, " << events.size() << " events\n";
+
+		uint64_t firstHash = 0;
+		for (int repetition = 0; repetition < repetitions; ++repetition) {
+			ReplayTimings timings = Run(header, events);
+			double seconds = timings.total / 1e9;
+			double gameSeconds = static_cast<double>(timings.ticks) / header.ticksPerSecond;
+
+			std::cout << "\nRun " << repetition + 1 << ": " << timings.ticks << " ticks (" << gameSeconds << " s of play), "
+				<< timings.inputs << " inputs, " << timings.generations << " generations in " << seconds * 1000.0 << " ms\n";
+			std::cout << "  " << (seconds > 0 ? timings.ticks / seconds : 0.0) << " ticks/s, "
+				<< (seconds > 0 ? gameSeconds / seconds : 0.0) << "x real time\n";
+			PrintPhase("input queue", timings.phases.inputs, timings);
+			PrintPhase("players", timings.phases.players, timings);
+			PrintPhase("bullets", timings.phases.bullets, timings);
+			PrintPhase("collisions", timings.phases.collisions, timings);
+			PrintPhase("cleanup", timings.phases.cleanup, timings);
+			PrintPhase("publish", timings.phases.publish, timings);
+			std::cout << "  inputs      " << std::setw(10) << (timings.inputs ? timings.inputTime / 1000.0 / timings.inputs : 0.0) << " us/input\n";
+			std::cout << "  generation  " << std::setw(10) << (timings.generations ? timings.generationTime / 1e6 / timings.generations : 0.0) << " ms/board\n";
+			std::cout << "  state hash  " << std::hex << timings.stateHash << std::dec << "\n";
+
+			if (repetition == 0) {
+				firstHash = timings.stateHash;
+			}
+			else if (timings.stateHash != firstHash) {
+				std::cerr << "Replay is not deterministic: final state differs between runs\n";
+				return 2;
+			}
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << "\n";
+		return 1;
+	}
+	return 0;
+}
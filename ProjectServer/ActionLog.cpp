@@ -0,0 +1,126 @@
+#include "ActionLog.h"
+#include <algorithm>
+#include <stdexcept>
+
+ActionLog::ActionLog(const std::string& path, size_t capacity, size_t batchSize, std::chrono::milliseconds flushInterval)
+	: m_records(capacity),
+	m_logged(0),
+	m_dropped(0),
+	m_written(0),
+	m_flushes(0),
+	m_batchSize(batchSize),
+	m_flushInterval(flushInterval),
+	m_wakeup(0),
+	m_wakeRequested(false),
+	m_file(path, std::ios_base::app)
+{
+	if (batchSize == 0) {
+		throw std::invalid_argument("Action log batch size must be positive");
+	}
+	if (!m_file.is_open()) {
+		throw std::runtime_error("Failed to open action log " + path);
+	}
+
+	m_file << "Log file created. Server started.\n";
+	m_file.flush();
+
+	m_writer = std::jthread([this](std::stop_token stopToken) {
+		while (!stopToken.stop_requested()) {
+			if (m_wakeup.try_acquire_for(m_flushInterval)) {
+				m_wakeRequested.store(false, std::memory_order_release);
+			}
+			Flush();
+		}
+		Flush(); // whatever was queued before shutdown
+		});
+}
+
+ActionLog::~ActionLog()
+{
+	m_writer.request_stop();
+	RequestWakeup();
+}
+
+// Lock-free for any number of producers; returns false (and counts a drop) when the ring is full
+bool ActionLog::Log(int playerId, const std::string& key)
+{
+	int64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	bool queued = m_records.TryPush([&](ActionRecord& record) {
+		record.timestamp = timestamp;
+		record.playerId = playerId;
+		size_t keyLength = std::min(key.size(), sizeof(record.key));
+		std::copy_n(key.data(), keyLength, record.key);
+		std::fill(record.key + keyLength, record.key + sizeof(record.key), '\0');
+		});
+	if (!queued) {
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	uint64_t logged = m_logged.fetch_add(1, std::memory_order_relaxed) + 1;
+	if (logged % m_batchSize == 0) {
+		RequestWakeup(); // a full batch is waiting, no need to sit out the interval
+	}
+	return true;
+}
+
+size_t ActionLog::GetCapacity() const
+{
+	return m_records.GetCapacity();
+}
+
+uint64_t ActionLog::GetLoggedCount() const
+{
+	return m_logged.load(std::memory_order_relaxed);
+}
+
+uint64_t ActionLog::GetDroppedCount() const
+{
+	return m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t ActionLog::GetWrittenCount() const
+{
+	return m_written.load(std::memory_order_relaxed);
+}
+
+uint64_t ActionLog::GetFlushCount() const
+{
+	return m_flushes.load(std::memory_order_relaxed);
+}
+
+// At most one release is ever outstanding, which a binary semaphore requires
+void ActionLog::RequestWakeup()
+{
+	if (!m_wakeRequested.exchange(true, std::memory_order_acq_rel)) {
+		m_wakeup.release();
+	}
+}
+
+// Formats everything queued so far and writes it with a single flush; runs on the writer thread only
+void ActionLog::Flush()
+{
+	m_batch.clear();
+	uint64_t count = 0;
+
+	ActionRecord record;
+	while (m_records.TryPop(record)) {
+		m_batch += std::to_string(record.timestamp);
+		m_batch += ' ';
+		m_batch += std::to_string(record.playerId);
+		m_batch += ' ';
+		m_batch.append(record.key, std::find(record.key, record.key + sizeof(record.key), '\0'));
+		m_batch += '\n';
+		++count;
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	m_file.write(m_batch.data(), m_batch.size());
+	m_file.flush();
+	m_written.fetch_add(count, std::memory_order_relaxed);
+	m_flushes.fetch_add(1, std::memory_order_relaxed);
+}
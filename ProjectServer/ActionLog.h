@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include "MpscRing.h"
+
+// One logged key press
+struct ActionRecord {
+    int64_t timestamp; // milliseconds since the Unix epoch
+    int32_t playerId;
+    char key[8];       // truncated, not null-terminated when all 8 bytes are used
+};
+
+// Action log written by a background thread. Request handlers push fixed-size
+// records into a bounded lock-free MPSC ring (see MpscRing.h) and never touch
+// the file; when the ring is full the record is dropped and counted.
+// The writer drains the ring in batches, every flush interval or as soon as a
+// batch worth of records has been queued, one line per record:
+//     <timestamp> <playerId> <key>
+class ActionLog
+{
+private:
+    // Member Variables
+    MpscRing<ActionRecord> m_records;
+    std::atomic<uint64_t> m_logged;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_written;
+    std::atomic<uint64_t> m_flushes;
+    size_t m_batchSize;
+    std::chrono::milliseconds m_flushInterval;
+    std::binary_semaphore m_wakeup;
+    std::atomic<bool> m_wakeRequested; // set while a release of m_wakeup is pending
+    std::ofstream m_file;
+    std::string m_batch;
+    std::jthread m_writer; // declared last so it stops before the ring is destroyed
+
+public:
+    // Constructor and Destructor
+    ActionLog(const std::string& path, size_t capacity, size_t batchSize, std::chrono::milliseconds flushInterval);
+    ~ActionLog();
+
+    // Logging
+    bool Log(int playerId, const std::string& key);
+
+    // Getters
+    size_t GetCapacity() const;
+    uint64_t GetLoggedCount() const;
+    uint64_t GetDroppedCount() const;
+    uint64_t GetWrittenCount() const;
+    uint64_t GetFlushCount() const;
+
+private:
+    // Helper Functions
+    void RequestWakeup();
+    void Flush();
+};
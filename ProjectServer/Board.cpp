@@ -1,12 +1,40 @@
 #include "Board.h"
+#include "WireFormat.h"
+#include "MapGenerator.h"
+
+const size_t MAX_BULLETS = 1024;
+const int MAX_PLAYERS = 4;
+const size_t STATE_LOG_CAPACITY = 4096;
+const size_t INPUT_QUEUE_CAPACITY = 1024; // inputs waiting for the next tick before new ones are dropped
+const uint64_t REPLAY_FLUSH_TICKS = 64;
+const double BULLET_SPEED = 0.5; // cells per second
+const double SHOT_COOLDOWN = 4.0; // seconds between two shots of the same tank
 
 Board::Board(int h, int w, int d)
 	:m_height(h),
 	m_width(w),
 	m_difficulty(d),
-	m_numberOfPlayers(0)
+	m_tanks(MAX_PLAYERS),
+	m_slots(MAX_PLAYERS),
+	m_bullets(MAX_BULLETS),
+	m_occupancy(h, w),
+	m_cells(static_cast<size_t>(h) * w, 0),
+	m_wallLayers(h, w),
+	m_stateLog(STATE_LOG_CAPACITY),
+	m_stateEpoch(std::chrono::steady_clock::now().time_since_epoch().count()),
+	m_seed(std::random_device{}()),
+	m_random(m_seed),
+	m_inputs(INPUT_QUEUE_CAPACITY)
 {
-	m_board.resize(h, std::vector<space>(w, { 0, false })); //start position value set to 0 by default
+	PublishSnapshot();
+}
+
+Board::~Board()
+{
+	StopSimulation();
+	if (m_replay) {
+		m_replay->Flush(m_tickCount);
+	}
 }
 
 int Board::GetHeight() const {
@@ -24,20 +52,20 @@ int Board::GetDifficulty() const
 
 uint8_t Board::GetNumberOfPlayers() const
 {
-	return m_numberOfPlayers;
+	return static_cast<uint8_t>(m_slots.Size());
 }
 
-std::list<std::shared_ptr<Bullet>> Board::GetBullets() const
+const BulletPool& Board::GetBullets() const
 {
-	return allBullets;
+	return m_bullets;
 }
 
 void Board::SetHeight() {
-	m_height = (rand() % 11) + 20;
+	m_height = std::uniform_int_distribution<int>(20, 30)(m_random);
 }
 
 void Board::SetWidth() {
-	m_width = (rand() % 11) + 20;
+	m_width = std::uniform_int_distribution<int>(20, 30)(m_random);
 }
 
 void Board::SetDifficulty() {
@@ -64,277 +92,349 @@ void Board::SetDifficultyAsValue(int x) {
 	}
 }
 
-crow::json::wvalue Board::GetPlayerState() {
-	crow::json::wvalue boardJson;
-	crow::json::wvalue::list playersJson;
-
-	for (const Tank& player : m_players) {
-		crow::json::wvalue playerJson;
-		playerJson["id"] = player.GetId();
-		playerJson["name"] = player.GetName();
-		playerJson["x"] = player.GetCoordX();
-		playerJson["y"] = player.GetCoordY();
-		playersJson.push_back(std::move(playerJson));
-	}
-
-	boardJson["players"] = std::move(playersJson);
-	return boardJson;
-}
-
-crow::json::wvalue Board::GetBoardState()
+// Runs the whole game (bullets, cooldowns, respawns) on a single thread at a fixed rate
+void Board::StartSimulation(int ticksPerSecond)
 {
-	crow::json::wvalue::list boardJson;
-	crow::json::wvalue::list rowJson;
-	int numRows = m_board.size();
-	int numCols = m_board[0].size();
-
-	// Print top border
-	for (int col = 0; col < numCols + 2; col++) {
-		rowJson.push_back('#');
+	if (ticksPerSecond <= 0) {
+		throw std::invalid_argument("Tick rate must be positive");
 	}
-	boardJson.push_back(std::move(rowJson));
-	rowJson.clear();
 
-	// Print board with left and right borders
-	for (int i = 0; i < numRows; i++) {
-		rowJson.push_back('#');  // Left border
-
-		for (int j = 0; j < numCols; j++) {
-			for (auto& player : m_players) {
-				if (player.GetCoordX() == i && player.GetCoordY() == j) {
-					rowJson.push_back('P');  // Mark the player's position
-					j++;
+	StopSimulation();
+	m_ticksPerSecond = ticksPerSecond;
+
+	m_simulationThread = std::jthread([this](std::stop_token stopToken) {
+		trace::SetThreadName(m_traceName);
+		const auto tickPeriod = std::chrono::microseconds(1'000'000 / m_ticksPerSecond);
+		const double deltaTime = 1.0 / m_ticksPerSecond;
+		auto nextTick = std::chrono::steady_clock::now() + tickPeriod;
+
+		while (!stopToken.stop_requested()) {
+			auto tickStart = std::chrono::steady_clock::now();
+			TickListener listener;
+			{
+				auto stateLock = LockState();
+				Tick(deltaTime);
+				listener = m_tickListener;
+			}
+			auto tickEnd = std::chrono::steady_clock::now();
+			uint64_t tick = m_tickCount;
+			trace::Record("tick", tickStart, tickEnd, "tick", tick);
+
+			// The frame comes from the snapshot the tick just published, so neither the encoding
+			// nor slow sends to subscribers hold up request handlers
+			if (listener) {
+				{
+					trace::Scope encodeScope("serialization", "tick", tick);
+					GetLatestSnapshot()->EncodeFrame(m_frameBuffer);
 				}
+				trace::Scope broadcastScope("broadcast", "tick", tick);
+				listener(m_frameBuffer);
 			}
 
-			switch (m_board[i][j].first) {
-			case 0: {
-				rowJson.push_back(' ');
-				break;
+			int64_t duration = std::chrono::duration_cast<std::chrono::microseconds>(tickEnd - tickStart).count();
+			m_lastTickDuration = duration;
+			if (duration > m_maxTickDuration) {
+				m_maxTickDuration = duration;
 			}
-			case 1: {
-				rowJson.push_back('+');// Breakable walls
-				break;
-			}
-			case 2: {
-				rowJson.push_back('#');  // Unbreakable walls
-				break;
-			}
-			default: {
-				rowJson.push_back(' ');
-				break;
+			if (LatencyHistogram* tickHistogram = m_tickHistogram.load(std::memory_order_relaxed)) {
+				tickHistogram->Record(static_cast<uint64_t>(duration));
 			}
+
+			// A late tick is counted and the schedule is reset instead of trying to catch up
+			if (tickEnd > nextTick) {
+				++m_tickOverruns;
+				nextTick = tickEnd;
 			}
 
+			std::this_thread::sleep_until(nextTick);
+			nextTick += tickPeriod;
 		}
-		rowJson.push_back('#');
-		boardJson.push_back(std::move(rowJson));
-		rowJson.clear();
+		});
+}
+
+void Board::StopSimulation()
+{
+	if (m_simulationThread.joinable()) {
+		m_simulationThread.request_stop();
+		m_simulationThread.join();
 	}
+}
 
-	// Print bottom border
-	for (int col = 0; col < numCols + 2; col++) {
-		rowJson.push_back('#');
+// Advances every cooldown, respawn and bullet by one step; the caller must hold the state lock.
+// Each step is a system over the tank and bullet components it needs, and is timed as a phase
+// (see TickPhaseTimes) that also goes to the trace.
+void Board::Tick(double deltaTime)
+{
+	const uint64_t tick = m_tickCount + 1;
+	auto phaseStart = std::chrono::steady_clock::now();
+	auto endPhase = [&phaseStart, tick](int64_t& phase, const char* name) {
+		auto now = std::chrono::steady_clock::now();
+		phase = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseStart).count();
+		trace::Record(name, phaseStart, now, "tick", tick);
+		phaseStart = now;
+		};
+
+	ApplyInputs(); // tank movement happens here, as the queued moves are applied
+	endPhase(m_lastTickPhases.inputs, "input drain");
+
+	UpdateCooldowns(deltaTime);
+	RespawnDestroyedTanks();
+	endPhase(m_lastTickPhases.players, "cooldowns and respawns");
+
+	MoveBullets(deltaTime);
+	endPhase(m_lastTickPhases.bullets, "bullet integration");
+
+	ResolveBulletCollisions();
+	CreditEliminations();
+	endPhase(m_lastTickPhases.collisions, "collision");
+	for (size_t bullet = 0; bullet < m_bullets.Size(); ++bullet) {
+		if (!m_bullets.IsActive(bullet)) {
+			m_stateLog.Record(ChangeType::BulletDespawned, m_bullets.HandleAt(bullet).slot, 0, 0, 0);
+		}
+	}
+	m_bullets.RemoveInactive();
+	endPhase(m_lastTickPhases.cleanup, "cleanup");
+
+	++m_tickCount;
+	PublishSnapshot();
+	endPhase(m_lastTickPhases.publish, "snapshot publish");
+	if (m_replay && m_tickCount % REPLAY_FLUSH_TICKS == 0) {
+		m_replay->Flush(m_tickCount);
 	}
-	boardJson.push_back(std::move(rowJson));
-	crow::json::wvalue matrix;
-	matrix["board"] = std::move(boardJson);
-	return matrix;
 }
 
-std::optional<Tank> Board::GetPlayerBasedOnCoord(int x, int y)
+// A wait for the lock is traced, and with a wait histogram set it is also recorded there; a free lock records 0
+std::unique_lock<std::mutex> Board::LockState()
 {
-	auto it = std::ranges::find_if(m_players, [x, y](const Tank& player) {
-		return player.GetCoordX() == x && player.GetCoordY() == y;
-		});
+	LatencyHistogram* lockWait = m_lockWaitHistogram.load(std::memory_order_relaxed);
+	std::unique_lock<std::mutex> lock(m_stateMutex, std::try_to_lock);
+	if (lock.owns_lock()) {
+		if (lockWait) {
+			lockWait->Record(0);
+		}
+		return lock;
+	}
 
-	if (it != m_players.end()) {
-		return *it;
+	auto waitStart = std::chrono::steady_clock::now();
+	lock.lock();
+	auto waitEnd = std::chrono::steady_clock::now();
+	trace::Record("state lock wait", waitStart, waitEnd);
+	if (lockWait) {
+		lockWait->Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(waitEnd - waitStart).count()));
 	}
-	return std::nullopt;
+	return lock;
 }
 
-void Board::RespawnPlayer(Tank& player)
+int Board::GetTickRate() const
 {
-	int respawnPosition = rand() % 4;
-	switch (respawnPosition) {
-	case 0:
-		Respawn(1, 1, player);
-		break;
-	case 1:
-		Respawn(1, m_width - 2, player);
-		break;
-	case 2:
-		Respawn(m_height - 2, 1, player);
-		break;
-	case 3:
-		Respawn(m_height - 2, m_width - 2, player);
-		break;
-	default:
-		throw std::invalid_argument("Invalid respawnPosition value");
-	}
+	return m_ticksPerSecond;
 }
 
-void Board::Respawn(int x, int y, Tank& player)
+// Called from the simulation thread after every tick with the encoded frame; the caller must hold the state lock
+void Board::SetTickListener(TickListener listener)
 {
-	player.SetCoordX(x);
-	player.SetCoordY(y);
-	m_board[x][y].first = 0;
-	ClearSurroundings(x, y);
+	m_tickListener = std::move(listener);
 }
 
-//helper function to modify how the board will be generated based off the selected difficulty
-void Board::SetPercentages(int& zeroPercent, int& onePercent, int& twoPercent, int& bombPercent) const {
-	switch (m_difficulty) {
-	case 1: // easy
-		zeroPercent = 60;
-		onePercent = 20;
-		twoPercent = 15;
-		bombPercent = 5;
-		break;
-	case 2: // normal
-		zeroPercent = 55;
-		onePercent = 20;
-		twoPercent = 25;
-		bombPercent = 10;
-		break;
-	case 3: // hard
-		zeroPercent = 50;
-		onePercent = 25;
-		twoPercent = 15;
-		bombPercent = 10;
-		break;
-	case 4: //very hard
-		zeroPercent = 40;
-		onePercent = 30;
-		twoPercent = 20;
-		bombPercent = 10;
-		break;
-	default:
-		throw std::runtime_error("Error: Difficulty not set correctly!");
-	}
+// Every tick's duration goes to tickDuration and every LockState wait to stateLockWait; null stops recording
+void Board::SetHistograms(LatencyHistogram* tickDuration, LatencyHistogram* stateLockWait)
+{
+	m_tickHistogram = tickDuration;
+	m_lockWaitHistogram = stateLockWait;
 }
 
-void Board::GenerateBoard() {
-	srand(time(0));
+// Names the simulation thread's track in exported traces; set it before StartSimulation
+void Board::SetTraceName(const std::string& name)
+{
+	m_traceName = name;
+}
 
-	int zeroPercent, onePercent, twoPercent, bombPercent;
-	SetPercentages(zeroPercent, onePercent, twoPercent, bombPercent);
+const TickPhaseTimes& Board::GetLastTickPhases() const
+{
+	return m_lastTickPhases;
+}
 
-	int maxBombs = 3 + m_difficulty;
-	int currentBombs = 0;
+// Reseeds the board's generator; the same seed and the same calls give the same game
+void Board::SetSeed(uint32_t seed)
+{
+	m_seed = seed;
+	m_random.seed(seed);
+}
 
-	m_walls.clear();
-	for (int i = 0; i < m_height; ++i) {
-		for (int j = 0; j < m_width; ++j) {
-			int random_value = std::rand() % 100; // Generates a random number between 0 and 99
-			if (random_value < zeroPercent) {
-				m_board[i][j].first = 0; // Zeroes
-			}
-			else if (random_value < zeroPercent + onePercent) {
-				m_board[i][j].first = 1; // Ones
-				m_walls.emplace_back(j, i, 1);
-			}
-			else if (random_value < zeroPercent + onePercent + twoPercent) {
-				m_board[i][j].first = 2; // Twos
-				m_walls.emplace_back(j, i, 2);
-			}
-			else if (currentBombs < maxBombs) {
-				m_board[i][j].first = 3;
-				m_walls.emplace_back(j, i, 3);
-				currentBombs++;
-			}
-			else {
-				m_board[i][j].first = 0;
-			}
+uint32_t Board::GetSeed() const
+{
+	return m_seed;
+}
 
-			m_board[i][j].second = false;
-		}
-	}
+// Records every following generation and input of this board; call before GenerateBoard
+void Board::StartRecording(const std::string& path, int ticksPerSecond)
+{
+	SetSeed(m_seed); // the header seed must describe the generator exactly as it is now
+	replay::Header header{ m_seed, static_cast<uint16_t>(m_height), static_cast<uint16_t>(m_width),
+		static_cast<uint8_t>(m_difficulty), static_cast<uint16_t>(ticksPerSecond) };
+	m_replay = std::make_unique<ReplayWriter>(path, header);
+}
 
-	int numRows = m_board.size();
-	int numCols = m_board[0].size();
-	if (numRows < numCols) {
-		for (int i = 3; i <= numRows; i++)
-			FixSquaring(numRows - 1);
+// Safe from any thread without the state lock; the input takes effect at the start of the next tick
+bool Board::SubmitInput(InputCommand command)
+{
+	return m_inputs.Push(std::move(command));
+}
+
+const InputQueue& Board::GetInputQueue() const
+{
+	return m_inputs;
+}
+
+uint64_t Board::GetTickCount() const
+{
+	return m_tickCount;
+}
+
+int64_t Board::GetLastTickDuration() const
+{
+	return m_lastTickDuration;
+}
+
+int64_t Board::GetMaxTickDuration() const
+{
+	return m_maxTickDuration;
+}
+
+uint64_t Board::GetTickOverruns() const
+{
+	return m_tickOverruns;
+}
+
+// Changes since the client's version, or a keyframe when the log no longer reaches back that far
+crow::json::wvalue Board::GetBoardDelta(uint64_t sinceVersion)
+{
+	trace::Scope serializationScope("serialization (delta)", "since", sinceVersion);
+	std::vector<StateChange> changes;
+	if (!m_stateLog.CollectSince(sinceVersion, changes)) {
+		return GetLatestSnapshot()->GetKeyframe(); // tagged with its own version, so the client resumes from there
 	}
-	else {
-		for (int i = 3; i <= numCols; i++)
-			FixSquaring(numCols - 1);
+
+	crow::json::wvalue delta;
+	crow::json::wvalue::list changesJson;
+	changesJson.reserve(changes.size());
+
+	for (const StateChange& change : changes) {
+		crow::json::wvalue changeJson;
+		switch (change.type) {
+		case ChangeType::Cell:
+			changeJson["type"] = "cell";
+			changeJson["x"] = change.x;
+			changeJson["y"] = change.y;
+			changeJson["value"] = BoardSnapshot::CellSymbol(change.value);
+			break;
+		case ChangeType::Tank:
+			changeJson["type"] = "tank";
+			changeJson["slot"] = change.id;
+			changeJson["x"] = change.x;
+			changeJson["y"] = change.y;
+			changeJson["direction"] = change.value;
+			break;
+		case ChangeType::BulletSpawned:
+			changeJson["type"] = "bulletSpawned";
+			changeJson["id"] = change.id;
+			changeJson["x"] = change.x;
+			changeJson["y"] = change.y;
+			changeJson["direction"] = change.value;
+			break;
+		case ChangeType::BulletDespawned:
+			changeJson["type"] = "bulletDespawned";
+			changeJson["id"] = change.id;
+			break;
+		}
+		changesJson.push_back(std::move(changeJson));
 	}
 
-	FixRowsAndColumns();
+	delta["changes"] = std::move(changesJson);
+	delta["version"] = m_stateLog.GetVersion();
+	delta["keyframe"] = false;
+	return delta;
 }
 
-void Board::FixSquaring(int k)
+// Wait-free for readers: the snapshot they get stays valid however many ticks run meanwhile
+std::shared_ptr<const BoardSnapshot> Board::GetLatestSnapshot() const
 {
-	int numRows = m_board.size();
-	int numCols = m_board[0].size();
+	return m_snapshot.load(std::memory_order_acquire);
+}
 
-	for (int i = 0; i <= numRows; i++) {
-		for (int j = 0; j <= numCols; j++) {
-			bool isSquare = true;
+// Blocks until a snapshot of the given tick or a later one is published; on timeout returns the latest anyway
+std::shared_ptr<const BoardSnapshot> Board::WaitForSnapshot(uint64_t tick, std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(m_publishMutex);
+	m_published.wait_for(lock, timeout, [this, tick] { return GetLatestSnapshot()->GetTick() >= tick; });
+	return GetLatestSnapshot();
+}
 
-			// Check if all elements in the current k x k submatrix are 2
-			for (int x = i; x < k; ++x) {
-				for (int y = j; y < k; ++y) {
-					if (m_board[x][y].first != 2) {
-						isSquare = false;
-						break;
-					}
-				}
-				if (!isSquare) break;
-			}
+uint64_t Board::GetStateVersion() const
+{
+	return m_stateLog.GetVersion();
+}
 
-			// If a square is found, fix it by changing one element to 0
-			if (isSquare) {
-				m_board[i][j].first = 0; // Change the top-left element of the square
-				return; // Fix only one circling for simplicity
-			}
-		}
+const Player* Board::GetPlayerBasedOnCoord(int x, int y) const
+{
+	int player = m_occupancy.GetTankAt(x, y);
+	if (player != -1) {
+		return &m_accounts[player];
 	}
+	return nullptr;
 }
 
-void Board::GenerateWalls() {
-	for (int i = 0; i < m_height; ++i) {
-		for (int j = 0; j < m_width; ++j) {
-			if (m_board[i][j].first == 1 || m_board[i][j].first == 2 || m_board[i][j].first == 3) {
-				Wall wall(j, i, m_board[i][j].first);
-				m_walls.push_back(wall);
-			}
-		}
+void Board::RespawnPlayer(int playerIndex)
+{
+	int respawnPosition = std::uniform_int_distribution<int>(0, 3)(m_random);
+	switch (respawnPosition) {
+	case 0:
+		Respawn(1, 1, playerIndex);
+		break;
+	case 1:
+		Respawn(1, m_width - 2, playerIndex);
+		break;
+	case 2:
+		Respawn(m_height - 2, 1, playerIndex);
+		break;
+	case 3:
+		Respawn(m_height - 2, m_width - 2, playerIndex);
+		break;
+	default:
+		throw std::invalid_argument("Invalid respawnPosition value");
 	}
 }
 
-void Board::FixRowsAndColumns() {
-	for (auto& row : m_board) {
-		bool allTwos = std::all_of(row.begin(), row.end(), [](const std::pair<int, bool>& cell) {
-			return cell.first == 2; 
-			});
+void Board::Respawn(int x, int y, int playerIndex)
+{
+	m_tanks.SetPosition(playerIndex, x, y);
+	PlaceTank(playerIndex);
+	SetCell(x, y, 0);
+	ClearSurroundings(x, y);
+}
 
-		if (allTwos) {
-			std::transform(row.begin(), row.begin() + row.size() / 2, row.begin(), [](std::pair<int, bool> cell) {
-				cell.first = 0; 
-				return cell;
-				});
-		}
+// Generates a new map in place from the board's own generator; replays redo it from the recorded seed
+void Board::GenerateBoard() {
+	RecordInput(replay::EventType::Generate, 0, static_cast<uint8_t>(m_difficulty));
+	ApplyMap(mapgen::Generate(m_random(), m_height, m_width, m_difficulty));
+}
+
+// Swaps in a map generated elsewhere (see MapPool); the caller must hold the state lock
+void Board::LoadMap(const mapgen::Map& map)
+{
+	if (map.height != m_height || map.width != m_width) {
+		throw std::invalid_argument("Map size does not match the board");
 	}
+	RecordInput(replay::EventType::LoadMap, 0, static_cast<uint8_t>(map.difficulty), map.seed);
+	ApplyMap(map);
+}
 
-	for (int col = 0; col < m_width; ++col) {
-		bool allTwos = true;
-		for (int row = 0; row < m_height; ++row) {
-			if (m_board[row][col].first != 2) {
-				allTwos = false;
-				break;
-			}
-		}
+std::vector<Wall> Board::GetWalls() const {
+	return m_wallLayers.GetWalls();
+}
 
-		if (allTwos) {
-			for (int row = 0; row < m_height / 2; ++row) {
-				m_board[row][col].first = 0; 
-			}
-		}
-	};
+size_t Board::CountWalls(int type) const {
+	return m_wallLayers.CountWalls(type);
 }
 
 // Helper function to set all spaces surrounding the start positions to 0
@@ -352,28 +452,54 @@ void Board::ClearSurroundings(int i, int j) {
 
 		// Check if within bounds
 		if (ni >= 0 && ni < m_height && nj >= 0 && nj < m_width) {
-			m_board[ni][nj].first = 0; // Set to path
+			SetCell(ni, nj, 0); // Set to path
 		}
 	}
 }
 
 
-Tank Board::GetPlayer(int playerNumber) const {
-	return m_players[playerNumber];
+const Player& Board::GetPlayer(int slot) const {
+	return m_accounts[slot];
 }
 
-int Board::GetValue(int x, int y) {
-	return m_board[x][y].first;
+const TankPool& Board::GetTanks() const
+{
+	return m_tanks;
 }
 
-void Board::InsertPlayer(const Tank& player)
+uint64_t Board::GetMapHash() const
 {
-	m_players.push_back(player);
-	m_numberOfPlayers++;
+	return m_mapHash;
+}
+
+int Board::GetValue(int x, int y) const {
+	return CellAt(x, y);
+}
+
+bool Board::IsFull() const
+{
+	return m_slots.IsFull();
+}
+
+bool Board::HasPlayer(int playerId) const
+{
+	return m_slots.Find(playerId).has_value();
+}
+
+void Board::InsertPlayer(const Player& player)
+{
+	std::optional<uint8_t> slot = m_slots.Insert(player.GetId());
+	if (!slot) {
+		throw std::invalid_argument("Player is already in the room or the room is full");
+	}
+
+	RecordInput(replay::EventType::Join, 0, player.GetRemainingLives(), static_cast<uint32_t>(player.GetId()));
+	m_accounts.push_back(player);
+	m_tanks.Add(player.GetRemainingLives(), player.GetScore());
 	std::vector<std::pair<int, int>> diagonalOffsets = { {1, 1} }; // Start positions will be the corners, but omitting the walls on the edges
 
 	for (const auto& offset : diagonalOffsets) {
-		switch (m_numberOfPlayers) {
+		switch (*slot + 1) {
 		case 1: // Top-left corner
 			InsertPlayer1(offset.first, offset.second);
 			break;
@@ -399,67 +525,62 @@ void Board::InsertPlayer(const Tank& player)
 
 void Board::InsertPlayer1(int i, int j) {
 	if (i < m_height && j < m_width) {
-		m_board[i][j].first = 0;
-		m_board[i][j].second = true;
+		SetCell(i, j, 0);
+		SetStartPosition(i, j, true);
 		ClearSurroundings(i, j);
-		m_players[0].SetCoordX(i);
-		m_players[0].SetCoordY(j);
+		m_tanks.SetPosition(0, i, j);
+		PlaceTank(0);
 	}
 }
 
 void Board::InsertPlayer2(int i, int j) {
 	if (i < m_height && j >= 0) {
-		m_board[i][j].second = true;
-		m_board[i][j].first = 0;
+		SetStartPosition(i, j, true);
+		SetCell(i, j, 0);
 		ClearSurroundings(i, j);
-		m_players[1].SetCoordX(i);
-		m_players[1].SetCoordY(j);
+		m_tanks.SetPosition(1, i, j);
+		PlaceTank(1);
 	}
 }
 
 void Board::InsertPlayer3(int i, int j) {
 	if (i >= 0 && j < m_width) {
-		m_board[i][j].second = true;
-		m_board[i][j].first = 0;
+		SetStartPosition(i, j, true);
+		SetCell(i, j, 0);
 		ClearSurroundings(i, j);
-		m_players[2].SetCoordX(i);
-		m_players[2].SetCoordY(j);
+		m_tanks.SetPosition(2, i, j);
+		PlaceTank(2);
 	}
 }
 
 void Board::InsertPlayer4(int i, int j) {
 	if (i >= 0 && j >= 0) {
-		m_board[i][j].second = true;
-		m_board[i][j].first = 0;
+		SetStartPosition(i, j, true);
+		SetCell(i, j, 0);
 		ClearSurroundings(i, j);
-		m_players[3].SetCoordX(i);
-		m_players[3].SetCoordY(j);
+		m_tanks.SetPosition(3, i, j);
+		PlaceTank(3);
 	}
 }
 
 bool Board::VerifyIfCoordIsPlayer(int x, int y) {
-	auto it = std::find_if(m_players.begin(), m_players.end(), [x, y](const Tank& player) {
-		return player.GetCoordX() == x && player.GetCoordY() == y;
-		});
-
-	return it != m_players.end(); 
+	return m_occupancy.GetTankAt(x, y) != -1;
 }
 
 void Board::TriggerBomb(double x, double y) {
 	const int radius = 10;
+	for (const auto& [i, j] : m_wallLayers.FindBlast(x, y, radius)) {
+		SetCell(i, j, 0);
+	}
+
 	for (int i = x - radius; i <= x + radius; ++i) {
 		for (int j = y - radius; j <= y + radius; ++j) {
 			if (i >= 0 && i < m_height && j >= 0 && j < m_width) {
 				if (abs(x - i) + abs(y - j) <= radius) {
-					if (m_board[i][j].first == 1) {
-						m_board[i][j].first = 0;
-					}
-					for (auto it = m_players.begin(); it != m_players.end();) {
-						if (it->GetCoordX() == i && it->GetCoordY() == j) {
-							it = m_players.erase(it);
-						}
-						else {
-							++it;
+					// Tanks caught in the blast are respawned on the next tick; erasing them would shift every player index
+					for (int player = m_occupancy.GetTankAt(i, j); player != -1; player = m_occupancy.GetNextTank(player)) {
+						if (m_tanks.IsAlive(player)) {
+							DestroyTank(player);
 						}
 					}
 				}
@@ -468,140 +589,377 @@ void Board::TriggerBomb(double x, double y) {
 	}
 }
 
-void Board::Update(double deltaTime, Bullet& bullet)
+// Cooldown system: only walks the cooldown component
+void Board::UpdateCooldowns(double deltaTime)
+{
+	for (double& cooldown : m_tanks.Cooldowns()) {
+		if (cooldown > 0.0) {
+			cooldown -= deltaTime;
+		}
+	}
+}
+
+// Respawn system: tanks destroyed during the previous tick come back at a random corner while they
+// have lives left; a tank out of lives stays down for the rest of the room
+void Board::RespawnDestroyedTanks()
 {
-	if (bullet.IsActive()) {
+	std::span<const uint8_t> alive = m_tanks.Alive();
+	for (size_t slot = 0; slot < alive.size(); ++slot) {
+		if (!alive[slot] && m_tanks.GetLives(slot) > 0) {
+			RespawnPlayer(static_cast<int>(slot));
+			m_tanks.SetAlive(slot, true);
+		}
+	}
+}
 
-		switch (bullet.GetDirection()) {
+// Projectile system: bullets that left the board are destroyed, the others advance
+void Board::MoveBullets(double deltaTime)
+{
+	for (size_t bullet = 0; bullet < m_bullets.Size(); ++bullet) {
+		if (m_bullets.GetY(bullet) < m_height && m_bullets.GetY(bullet) >= 0 &&
+			m_bullets.GetX(bullet) >= 0 && m_bullets.GetX(bullet) < m_width) {
+			Update(deltaTime, bullet);
+		}
+		else {
+			m_bullets.Destroy(bullet);
+		}
+	}
+}
+
+// Scoring system: one point per tank hit, credited to the slot that fired the bullet
+void Board::CreditEliminations()
+{
+	for (uint8_t owner : m_eliminations) {
+		if (owner >= m_tanks.Size()) {
+			continue;
+		}
+		m_tanks.AddScore(owner, 1);
+		Player& account = m_accounts[owner];
+		if (m_tanks.GetScore(owner) > account.GetHighScore()) {
+			account.SetHighScore(m_tanks.GetScore(owner));
+		}
+	}
+	m_eliminations.clear();
+}
+
+void Board::Update(double deltaTime, size_t bullet)
+{
+	if (m_bullets.IsActive(bullet)) {
+		double distance = m_bullets.GetSpeed(bullet) * deltaTime;
+
+		switch (m_bullets.GetDirection(bullet)) {
 		case Direction::UP:
-			bullet.SetY(bullet.GetY() - bullet.GetSpeed() * deltaTime);
+			m_bullets.SetY(bullet, m_bullets.GetY(bullet) - distance);
 			break;
 		case Direction::DOWN:
-			bullet.SetY(bullet.GetY() + bullet.GetSpeed() * deltaTime);
+			m_bullets.SetY(bullet, m_bullets.GetY(bullet) + distance);
 			break;
 		case Direction::LEFT:
-			bullet.SetX(bullet.GetX() - bullet.GetSpeed() * deltaTime);
+			m_bullets.SetX(bullet, m_bullets.GetX(bullet) - distance);
 			break;
 		case Direction::RIGHT:
-			bullet.SetX(bullet.GetX() + bullet.GetSpeed() * deltaTime);
+			m_bullets.SetX(bullet, m_bullets.GetX(bullet) + distance);
 			break;
 		}
+	}
+}
+
+// Runs after every bullet has moved: bullets sharing a cell destroy each other, then walls and tanks are looked up in O(1)
+void Board::ResolveBulletCollisions()
+{
+	m_occupancy.RebuildBullets(m_bullets);
+
+	for (size_t bullet = 0; bullet < m_bullets.Size(); ++bullet) {
+		int row, col;
+		if (!m_bullets.IsActive(bullet) || !OccupancyGrid::BulletCell(m_bullets, bullet, row, col)) {
+			continue;
+		}
 
-		for (auto& currentBullet : allBullets) {
-			if (currentBullet.get() != &bullet && currentBullet->IsActive() &&
-				currentBullet->GetX() == bullet.GetX() && currentBullet->GetY() == bullet.GetY()) {
-				currentBullet->Destroy();
-				bullet.Destroy();
-				return;
+		for (int other = m_occupancy.GetBulletAt(row, col); other != -1; other = m_occupancy.GetNextBullet(other)) {
+			if (other != static_cast<int>(bullet) && m_bullets.IsActive(other)) {
+				m_bullets.Destroy(other);
+				m_bullets.Destroy(bullet);
 			}
 		}
+		if (!m_bullets.IsActive(bullet)) {
+			continue;
+		}
 
-		int spaceType = GetSpaceType(bullet.GetY() - 1, bullet.GetX() - 1);
+		int spaceType = GetSpaceType(row, col);
 		if (spaceType == 2) {
-			bullet.Destroy();
+			m_bullets.Destroy(bullet);
 		}
 		else if (spaceType == 1) {
-			SetSpaceType(bullet.GetY() - 1, bullet.GetX() - 1, 0);
-			bullet.Destroy();
+			SetSpaceType(row, col, 0);
+			m_bullets.Destroy(bullet);
+		}
+		else if (spaceType == 3) {
+			SetSpaceType(row, col, 0);
+			m_bullets.Destroy(bullet);
+			trace::Scope bombScope("bomb resolution");
+			TriggerBomb(row, col);
+		}
 
-			if (m_board[bullet.GetY() - 1][bullet.GetX() - 1].first == 3) {
-				TriggerBomb(bullet.GetY() - 1, bullet.GetX() - 1);
+		// Tanks already destroyed this tick wait for their respawn and neither stop the bullet nor count again
+		bool hit = false;
+		for (int player = m_occupancy.GetTankAt(row, col); player != -1; player = m_occupancy.GetNextTank(player)) {
+			if (m_tanks.IsAlive(player)) {
+				DestroyTank(player); // respawned on the next tick if it has lives left
+				hit = true;
 			}
 		}
-		if (VerifyIfCoordIsPlayer(bullet.GetY() - 1, bullet.GetX() - 1)) {
-			auto player = GetPlayerBasedOnCoord(bullet.GetY() - 1, bullet.GetX() - 1);
-			if (player) {
-				RespawnPlayer(*player);
-			}
-			bullet.GetTank().GetAnElimination();
-			bullet.Destroy();
+		if (hit) {
+			m_eliminations.push_back(m_bullets.GetOwner(bullet)); // credited by CreditEliminations
+			m_bullets.Destroy(bullet);
 		}
 	}
 }
 
+// Player ids are the persistent ones clients know; ids without a tank in this room are ignored
 void Board::Shoot(int playerId) {
-	if (!m_players[playerId].CanShoot()) return;
-
-	m_players[playerId].SetLastShootTime(std::chrono::steady_clock::now());
-
-	// Use shared_ptr for safe memory management
-	auto bullet = std::make_shared<Bullet>(
-		m_players[playerId].GetCoordY() + 1,
-		m_players[playerId].GetCoordX() + 1,
-		m_players[playerId].GetDirection(),
-		m_players[playerId]
-	);
-
-	bullet->LockMutex();
-	allBullets.push_back(bullet);
-
-	std::thread bulletThread([this, bullet]() {
-		while (bullet->GetY() < m_height && bullet->GetY() >= 0 &&
-			bullet->GetX() >= 0 && bullet->GetX() < m_width &&
-			bullet->IsActive()) {
-			Update(1, *bullet);
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-		}
+	std::optional<uint8_t> slot = m_slots.Find(playerId);
+	if (!slot) return;
 
-		// Deactivate the bullet and remove it safely
-		bullet->Destroy();
-		bullet->LockMutex();
-		allBullets.remove(bullet); // Remove from the container
-		});
+	RecordInput(replay::EventType::Shoot, 0, 0, static_cast<uint32_t>(playerId));
+	if (!m_tanks.IsAlive(*slot) || !m_tanks.CanShoot(*slot)) return;
+
+	m_tanks.SetCooldown(*slot, SHOT_COOLDOWN);
 
-	bulletThread.detach(); // Let the thread run independently
+	// Bullets use bordered coordinates (x = column + 1, y = row + 1) and start one cell ahead of the tank
+	Direction direction = m_tanks.GetDirection(*slot);
+	double x = m_tanks.GetCol(*slot) + 1;
+	double y = m_tanks.GetRow(*slot) + 1;
+	switch (direction) {
+	case Direction::UP:
+		y -= 1.0;
+		break;
+	case Direction::DOWN:
+		y += 1.0;
+		break;
+	case Direction::LEFT:
+		x -= 1.0;
+		break;
+	case Direction::RIGHT:
+		x += 1.0;
+		break;
+	}
+
+	// The bullet is advanced by the simulation tick, not by a thread of its own; its owner is the shooter's slot
+	auto bullet = m_bullets.Spawn(x, y, direction, BULLET_SPEED, *slot);
+	if (bullet) {
+		m_stateLog.Record(ChangeType::BulletSpawned, bullet->slot, static_cast<int>(x), static_cast<int>(y), static_cast<uint8_t>(direction));
+	}
 }
 void Board::Move(int playerId, const char& key) {
-	if (key == 'W' || key == 'w')m_players[playerId].SetDirection(Direction::UP);
-	if (key == 'S' || key == 's')m_players[playerId].SetDirection(Direction::DOWN);
-	if (key == 'A' || key == 'a')m_players[playerId].SetDirection(Direction::LEFT);
-	if (key == 'D' || key == 'd')m_players[playerId].SetDirection(Direction::RIGHT);
-
-	switch (m_players[playerId].GetDirection()) {
+	std::optional<uint8_t> slot = m_slots.Find(playerId);
+	if (!slot) return;
+
+	RecordInput(replay::EventType::Move, 0, static_cast<uint8_t>(key), static_cast<uint32_t>(playerId));
+	if (!m_tanks.IsAlive(*slot)) return;
+	if (key == 'W' || key == 'w')m_tanks.SetDirection(*slot, Direction::UP);
+	if (key == 'S' || key == 's')m_tanks.SetDirection(*slot, Direction::DOWN);
+	if (key == 'A' || key == 'a')m_tanks.SetDirection(*slot, Direction::LEFT);
+	if (key == 'D' || key == 'd')m_tanks.SetDirection(*slot, Direction::RIGHT);
+
+	int row = m_tanks.GetRow(*slot);
+	int col = m_tanks.GetCol(*slot);
+	switch (m_tanks.GetDirection(*slot)) {
 	case Direction::UP:
-		if (m_players[playerId].GetCoordX() - 1 >= 0)
-			if (GetValue(m_players[playerId].GetCoordX() - 1, m_players[playerId].GetCoordY()) == 0)
-				m_players[playerId].SetCoordX(m_players[playerId].GetCoordX() - 1);
+		if (row - 1 >= 0 && GetValue(row - 1, col) == 0)
+			--row;
 		break;
 	case Direction::DOWN:
-		if (m_players[playerId].GetCoordX() + 1 < GetHeight())
-			if (GetValue(m_players[playerId].GetCoordX() + 1, m_players[playerId].GetCoordY()) == 0)
-				m_players[playerId].SetCoordX(m_players[playerId].GetCoordX() + 1);
+		if (row + 1 < GetHeight() && GetValue(row + 1, col) == 0)
+			++row;
 		break;
 	case Direction::LEFT:
-		if (m_players[playerId].GetCoordY() - 1 >= 0)
-			if (GetValue(m_players[playerId].GetCoordX(), m_players[playerId].GetCoordY() - 1) == 0)
-				m_players[playerId].SetCoordY(m_players[playerId].GetCoordY() - 1);
+		if (col - 1 >= 0 && GetValue(row, col - 1) == 0)
+			--col;
 		break;
 	case Direction::RIGHT:
-		if (m_players[playerId].GetCoordY() + 1 < GetWidth())
-			if (GetValue(m_players[playerId].GetCoordX(), m_players[playerId].GetCoordY() + 1) == 0)
-				m_players[playerId].SetCoordY(m_players[playerId].GetCoordY() + 1);
+		if (col + 1 < GetWidth() && GetValue(row, col + 1) == 0)
+			++col;
 		break;
 	}
+
+	m_tanks.SetPosition(*slot, row, col);
+	PlaceTank(*slot);
 }
 
 bool Board::VerifyBulletCoord(int x, int y) const
 {
-	return std::ranges::any_of(allBullets, [x, y](const auto& bullet) {
-		return bullet->GetX() == x && bullet->GetY() == y;
-		});
+	for (size_t bullet = 0; bullet < m_bullets.Size(); ++bullet) {
+		if (m_bullets.GetX(bullet) == x && m_bullets.GetY(bullet) == y) {
+			return true;
+		}
+	}
+	return false;
 }
 
 int Board::GetSpaceType(double x, double y) const {
 	if (x >= 0 && x < m_height && y >= 0 && y < m_width) {
-		return m_board[x][y].first;
+		return CellAt(x, y);
 	}
 	return -1;
 }
 
 void Board::SetSpaceType(double x, double y, int type) {
 	if (x >= 0 && x < m_height && y >= 0 && y < m_width) {
-		m_board[x][y].first = type;
+		SetCell(x, y, type);
+	}
+}
+
+BoardView Board::GetBoard() const
+{
+	return BoardView{ m_cells, m_height, m_width };
+}
+
+bool Board::IsStartPosition(int x, int y) const
+{
+	return m_wallLayers.IsStart(x, y);
+}
+
+void Board::SetStartPosition(int x, int y, bool isStart)
+{
+	m_wallLayers.SetStart(x, y, isStart);
+}
+
+bool Board::IsWallAt(int x, int y) const
+{
+	return x >= 0 && x < m_height && y >= 0 && y < m_width && m_wallLayers.IsWall(x, y);
+}
+
+// Single write path for cells: m_cells is updated first and the wall planes follow as its index
+void Board::SetCell(int x, int y, uint8_t type)
+{
+	m_cells[static_cast<size_t>(x) * m_width + y] = type;
+	m_cellsDirty = true;
+	m_wallLayers.SetType(x, y, type);
+	m_stateLog.Record(ChangeType::Cell, 0, x, y, type);
+}
+
+// Copies what readers need into a new snapshot and swaps it in; the caller must hold the state lock.
+// Cells are only copied when one of them changed, and the encoded bodies are carried over
+// while the state version stays the same.
+void Board::PublishSnapshot()
+{
+	auto snapshot = std::make_shared<BoardSnapshot>();
+	std::shared_ptr<const BoardSnapshot> previous = m_snapshot.load(std::memory_order_relaxed);
+
+	if (m_cellsDirty || !m_publishedCells) {
+		m_publishedCells = std::make_shared<const std::vector<uint8_t>>(m_cells);
+		m_cellsDirty = false;
+	}
+
+	snapshot->m_tick = m_tickCount;
+	snapshot->m_version = m_stateLog.GetVersion();
+	snapshot->m_epoch = m_stateEpoch;
+	snapshot->m_mapHash = m_mapHash;
+	snapshot->m_height = m_height;
+	snapshot->m_width = m_width;
+	snapshot->m_ticksPerSecond = m_ticksPerSecond;
+	snapshot->m_full = IsFull();
+	snapshot->m_cells = m_publishedCells;
+
+	snapshot->m_tanks.reserve(m_tanks.Size());
+	for (size_t slot = 0; slot < m_tanks.Size(); ++slot) {
+		snapshot->m_tanks.push_back(TankState{ m_accounts[slot].GetId(), m_accounts[slot].GetName(), m_tanks.GetRow(slot), m_tanks.GetCol(slot),
+			static_cast<uint8_t>(m_tanks.GetDirection(slot)), m_tanks.IsAlive(slot), m_tanks.GetLives(slot), m_tanks.GetScore(slot) });
+	}
+
+	snapshot->m_bullets.reserve(m_bullets.Size());
+	for (size_t bullet = 0; bullet < m_bullets.Size(); ++bullet) {
+		snapshot->m_bullets.push_back(BulletState{ m_bullets.HandleAt(bullet).slot, m_bullets.GetOwner(bullet),
+			static_cast<uint8_t>(m_bullets.GetDirection(bullet)), m_bullets.GetX(bullet), m_bullets.GetY(bullet) });
 	}
+
+	if (previous && previous->m_version == snapshot->m_version && previous->m_cells == snapshot->m_cells) {
+		snapshot->m_bodies = previous->m_bodies;
+	}
+	else {
+		snapshot->m_bodies = std::make_shared<BoardSnapshot::EncodedBodies>();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_publishMutex); // so a waiter cannot miss the notification between its check and its wait
+		m_snapshot.store(std::move(snapshot), std::memory_order_release);
+	}
+	m_published.notify_all();
+}
+
+// Keeps the occupancy index and the change log in step with a tank's coordinates
+void Board::PlaceTank(int playerIndex)
+{
+	int row = m_tanks.GetRow(playerIndex);
+	int col = m_tanks.GetCol(playerIndex);
+	m_occupancy.PlaceTank(playerIndex, row, col);
+	m_stateLog.Record(ChangeType::Tank, playerIndex, row, col, static_cast<uint8_t>(m_tanks.GetDirection(playerIndex)));
+}
+
+// Every hit costs a life; the tank comes back on the next tick while it has lives left
+void Board::DestroyTank(int playerIndex)
+{
+	m_tanks.SetAlive(playerIndex, false);
+	m_tanks.LoseLife(playerIndex);
+	m_stateLog.Record(ChangeType::Tank, playerIndex, m_tanks.GetRow(playerIndex), m_tanks.GetCol(playerIndex), static_cast<uint8_t>(m_tanks.GetDirection(playerIndex)));
+}
+
+void Board::RecordInput(replay::EventType type, uint8_t player, uint8_t value, uint32_t argument)
+{
+	if (m_replay) {
+		m_replay->Append(m_tickCount, type, player, value, argument);
+	}
+}
+
+// Bulk rewrites are not logged cell by cell; readers get a keyframe instead
+void Board::ApplyMap(const mapgen::Map& map)
+{
+	m_stateLog.BeginKeyframe();
+	m_difficulty = map.difficulty;
+	m_mapHash = map.hash;
+	std::copy(map.cells.begin(), map.cells.end(), m_cells.begin());
+	m_wallLayers.Load(m_cells);
+	m_wallLayers.ClearStarts();
+	m_cellsDirty = true;
+	m_stateLog.EndKeyframe();
+	PublishSnapshot();
+}
+
+// Applies everything queued since the last tick, in arrival order. Inputs pushed while
+// draining wait for the next tick so a flood of them cannot stretch this one.
+void Board::ApplyInputs()
+{
+	size_t pending = m_inputs.GetDepth();
+	InputCommand command;
+	for (size_t applied = 0; applied < pending && m_inputs.Pop(command); ++applied) {
+		switch (command.type) {
+		case InputType::Move:
+			Move(command.playerId, command.key);
+			break;
+		case InputType::Shoot:
+			Shoot(command.playerId);
+			break;
+		case InputType::Join:
+			// The handler checked this too, but another join may have been applied since
+			if (!HasPlayer(command.playerId) && !IsFull()) {
+				InsertPlayer(Player(command.playerId, command.name, "", command.highScore, command.lives, 0));
+			}
+			break;
+		}
+	}
+}
+
+uint8_t Board::CellAt(int x, int y) const
+{
+	return m_cells[static_cast<size_t>(x) * m_width + y];
+}
+
+uint8_t BoardView::At(int x, int y) const
+{
+	return cells[static_cast<size_t>(x) * width + y];
 }
 
-std::vector<std::vector<std::pair<int, bool>>> Board::GetBoard() const
+std::span<const uint8_t> BoardView::Row(int x) const
 {
-	return m_board;
+	return cells.subspan(static_cast<size_t>(x) * width, width);
 }
\ No newline at end of file
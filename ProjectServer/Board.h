@@ -5,41 +5,122 @@
 #include <crow.h>
 #include <stdexcept>
 #include <algorithm>
-#include "Bullet.h";
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <random>
+#include <span>
+#include <cstdint>
+#include <string>
+#include "BulletPool.h"
+#include "OccupancyGrid.h"
+#include "WallLayers.h"
+#include "StateLog.h"
+#include "InputQueue.h"
+#include "SlotTable.h"
+#include "Replay.h"
+#include "BoardSnapshot.h"
+#include "TankPool.h"
+#include "MapGenerator.h"
+#include "LatencyHistogram.h"
+#include "TraceRecorder.h"
 
-import Wall;
+import Player;
 
-using space = std::pair<int, bool>; 
-// int = type of space on the board, bool = determines whether it is a start position
-using boardElements::Wall;
+using boardElements::Player;
+
+
+// Time spent in each phase of the last tick, in nanoseconds
+struct TickPhaseTimes {
+    int64_t inputs = 0;     // queued moves, shots and joins
+    int64_t players = 0;    // cooldowns and respawns
+    int64_t bullets = 0;    // movement and out-of-bounds checks
+    int64_t collisions = 0;
+    int64_t cleanup = 0;    // despawn bookkeeping
+    int64_t publish = 0;    // building the snapshot for readers
+};
+
+// Non-owning, read-only view over the row-major cell codes of a board
+struct BoardView {
+    std::span<const uint8_t> cells;
+    int height;
+    int width;
+
+    uint8_t At(int x, int y) const;
+    std::span<const uint8_t> Row(int x) const;
+};
 
 class Board
 {
+public:
+    using TickListener = std::function<void(const std::string& frame)>;
+
 protected:
     // Member Variables
     int m_height;
     int m_width;
     int m_difficulty = 1;
-    std::vector<std::vector<space>> m_board;
-    std::vector<Tank> m_players;
-    std::vector<Wall> m_walls;
-    int m_numberOfPlayers;
-    std::list<std::shared_ptr<Bullet>> allBullets;
+    std::vector<Player> m_accounts; // indexed by slot; names, ids and high scores only
+    TankPool m_tanks;               // per-slot position, direction, cooldown, lives and score components
+    SlotTable m_slots;              // player id -> slot
+    BulletPool m_bullets;
+    std::vector<uint8_t> m_eliminations; // owner slots of this tick's hits, drained by the scoring system
+    OccupancyGrid m_occupancy;
+    std::vector<uint8_t> m_cells; // authoritative type code per cell, row-major; written only through SetCell and ApplyMap
+    WallLayers m_wallLayers;      // wall planes derived from m_cells, plus the start positions
+    StateLog m_stateLog;
+    int64_t m_stateEpoch;
+    uint64_t m_mapHash = 0; // map the board was last loaded with (see mapgen::Hash)
+
+    // Determinism and Replay
+    uint32_t m_seed;
+    std::mt19937 m_random;                  // every random decision of the board comes from here
+    std::unique_ptr<ReplayWriter> m_replay; // null unless the room is being recorded
+
+    // Published State
+    std::atomic<std::shared_ptr<const BoardSnapshot>> m_snapshot;
+    std::shared_ptr<const std::vector<uint8_t>> m_publishedCells; // reused until a cell changes
+    bool m_cellsDirty = true;
+    std::mutex m_publishMutex;           // only pairs with m_published
+    std::condition_variable m_published; // notified after every publish
+
+    // Simulation
+    std::mutex m_stateMutex;
+    int m_ticksPerSecond = 20;
+    std::atomic<uint64_t> m_tickCount = 0;
+    std::atomic<int64_t> m_lastTickDuration = 0; // microseconds
+    std::atomic<int64_t> m_maxTickDuration = 0;  // microseconds
+    std::atomic<uint64_t> m_tickOverruns = 0;
+    InputQueue m_inputs;
+    TickPhaseTimes m_lastTickPhases;
+    TickListener m_tickListener;
+    std::string m_frameBuffer; // only touched by the simulation thread
+    std::atomic<LatencyHistogram*> m_tickHistogram = nullptr;     // shared by every room, null when not monitored
+    std::atomic<LatencyHistogram*> m_lockWaitHistogram = nullptr; // waits for m_stateMutex, ticks included
+    std::string m_traceName = "simulation"; // track of the simulation thread in exported traces
+    std::jthread m_simulationThread; // declared last so it stops before the state it touches is destroyed
 
 public:
     // Constructor and Destructor
     Board(int h, int w, int d);
-    ~Board() = default;
+    ~Board();
 
     // Getters
     int GetHeight() const;
     int GetWidth() const;
     int GetDifficulty() const;
     uint8_t GetNumberOfPlayers() const;
-    std::list<std::shared_ptr<Bullet>> GetBullets() const;
-    Tank GetPlayer(int playerNumber) const;
-    int GetValue(int x, int y);
-    std::vector<std::vector<std::pair<int, bool>>> GetBoard() const;
+    const BulletPool& GetBullets() const;
+    const Player& GetPlayer(int slot) const;
+    const TankPool& GetTanks() const;
+    uint64_t GetMapHash() const;
+    int GetValue(int x, int y) const;
+    BoardView GetBoard() const;
+    bool IsStartPosition(int x, int y) const;
 
     // Setters
     void SetHeight();
@@ -47,24 +128,55 @@ public:
     void SetDifficultyAsValue(int x);
     void SetDifficulty(); // difficulty setter with menu
 
+    // Simulation
+    void StartSimulation(int ticksPerSecond);
+    void StopSimulation();
+    void Tick(double deltaTime);
+    std::unique_lock<std::mutex> LockState();
+    void SetTickListener(TickListener listener);
+    void SetHistograms(LatencyHistogram* tickDuration, LatencyHistogram* stateLockWait);
+    void SetTraceName(const std::string& name);
+    int GetTickRate() const;
+    uint64_t GetTickCount() const;
+    int64_t GetLastTickDuration() const;
+    int64_t GetMaxTickDuration() const;
+    uint64_t GetTickOverruns() const;
+    const TickPhaseTimes& GetLastTickPhases() const;
+    bool SubmitInput(InputCommand command);
+    const InputQueue& GetInputQueue() const;
+
+    // Determinism and Replay
+    void SetSeed(uint32_t seed);
+    uint32_t GetSeed() const;
+    void StartRecording(const std::string& path, int ticksPerSecond);
+
     // Serializing
-    crow::json::wvalue GetPlayerState();
-    crow::json::wvalue GetBoardState();
+    std::shared_ptr<const BoardSnapshot> GetLatestSnapshot() const;
+    std::shared_ptr<const BoardSnapshot> WaitForSnapshot(uint64_t tick, std::chrono::milliseconds timeout);
+    crow::json::wvalue GetBoardDelta(uint64_t sinceVersion);
+    uint64_t GetStateVersion() const;
 
     // State Management
-    void Update(double deltaTime, Bullet& bullet);
+    void Update(double deltaTime, size_t bullet);
+    void ResolveBulletCollisions();
+    void UpdateCooldowns(double deltaTime);
+    void RespawnDestroyedTanks();
+    void MoveBullets(double deltaTime);
+    void CreditEliminations();
     void UpdateBoard(crow::json::rvalue body);
 
     // Game Mechanics
-    void RespawnPlayer(Tank& player);
-    void Respawn(int x, int y, Tank& player);
+    void RespawnPlayer(int playerIndex);
+    void Respawn(int x, int y, int playerIndex);
     void Shoot(int playerId);
     void Move(int playerId, const char& key);
     bool VerifyBulletCoord(int x, int y) const;
 
     // Board Manipulation
     void GenerateBoard();
-    void GenerateWalls();
+    void LoadMap(const mapgen::Map& map);
+    std::vector<Wall> GetWalls() const;
+    size_t CountWalls(int type) const;
     void RenderWalls();
     void PlaceBomb(int x, int y);
     void TriggerBomb(double x, double y);
@@ -73,18 +185,26 @@ public:
     bool IsWallAt(int x, int y) const;
     int GetSpaceType(double x, double y) const;
     void SetSpaceType(double x, double y, int type);
-    std::optional<Tank> GetPlayerBasedOnCoord(int x, int y);
+    const Player* GetPlayerBasedOnCoord(int x, int y) const;
     bool VerifyIfCoordIsPlayer(int x, int y);
 
     // Player Insertion
-    void InsertPlayer(const Tank& player);
+    bool IsFull() const;
+    bool HasPlayer(int playerId) const;
+    void InsertPlayer(const Player& player);
 
 private:
     // Helper Functions
+    uint8_t CellAt(int x, int y) const;
+    void SetCell(int x, int y, uint8_t type);
+    void PublishSnapshot();
+    void PlaceTank(int playerIndex);
+    void RecordInput(replay::EventType type, uint8_t player, uint8_t value, uint32_t argument = 0);
+    void ApplyMap(const mapgen::Map& map);
+    void ApplyInputs();
+    void DestroyTank(int playerIndex);
+    void SetStartPosition(int x, int y, bool isStart);
     void ClearSurroundings(int x, int y);
-    void SetPercentages(int& zeroPercent, int& onePercent, int& twoPercent, int& bombPercent) const;
-    void FixSquaring(int k);
-    void FixRowsAndColumns();
 
     // Helper Functions for Player Insertion
     void InsertPlayer1(int i, int j);
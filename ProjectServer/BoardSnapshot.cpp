@@ -0,0 +1,319 @@
+#include "BoardSnapshot.h"
+#include <algorithm>
+#include "WireFormat.h"
+#include "MapGenerator.h"
+#include "TraceRecorder.h"
+
+uint64_t BoardSnapshot::GetTick() const
+{
+	return m_tick;
+}
+
+uint64_t BoardSnapshot::GetVersion() const
+{
+	return m_version;
+}
+
+uint64_t BoardSnapshot::GetMapHash() const
+{
+	return m_mapHash;
+}
+
+int BoardSnapshot::GetHeight() const
+{
+	return m_height;
+}
+
+int BoardSnapshot::GetWidth() const
+{
+	return m_width;
+}
+
+const std::vector<TankState>& BoardSnapshot::GetTanks() const
+{
+	return m_tanks;
+}
+
+const std::vector<BulletState>& BoardSnapshot::GetBullets() const
+{
+	return m_bullets;
+}
+
+bool BoardSnapshot::HasPlayer(int playerId) const
+{
+	return std::ranges::any_of(m_tanks, [playerId](const TankState& tank) {
+		return tank.id == playerId;
+		});
+}
+
+bool BoardSnapshot::IsFull() const
+{
+	return m_full;
+}
+
+crow::json::wvalue BoardSnapshot::GetPlayerState() const
+{
+	crow::json::wvalue boardJson;
+	crow::json::wvalue::list playersJson;
+
+	for (const TankState& tank : m_tanks) {
+		crow::json::wvalue playerJson;
+		playerJson["id"] = tank.id;
+		playerJson["name"] = tank.name;
+		playerJson["x"] = tank.x;
+		playerJson["y"] = tank.y;
+		playersJson.push_back(std::move(playerJson));
+	}
+
+	boardJson["players"] = std::move(playersJson);
+	return boardJson;
+}
+
+crow::json::wvalue BoardSnapshot::GetBoardState() const
+{
+	// Rows of symbols with a '#' border; tanks are drawn over whatever cell they stand on
+	std::vector<char> symbols(m_cells->size());
+	std::transform(m_cells->begin(), m_cells->end(), symbols.begin(), CellSymbol);
+	for (const TankState& tank : m_tanks) {
+		symbols[static_cast<size_t>(tank.x) * m_width + tank.y] = 'P';
+	}
+
+	crow::json::wvalue::list boardJson;
+	crow::json::wvalue::list rowJson;
+
+	// Print top border
+	for (int col = 0; col < m_width + 2; col++) {
+		rowJson.push_back('#');
+	}
+	boardJson.push_back(std::move(rowJson));
+	rowJson.clear();
+
+	// Print board with left and right borders
+	for (int i = 0; i < m_height; i++) {
+		rowJson.push_back('#');  // Left border
+		for (int j = 0; j < m_width; j++) {
+			rowJson.push_back(symbols[static_cast<size_t>(i) * m_width + j]);
+		}
+		rowJson.push_back('#');
+		boardJson.push_back(std::move(rowJson));
+		rowJson.clear();
+	}
+
+	// Print bottom border
+	for (int col = 0; col < m_width + 2; col++) {
+		rowJson.push_back('#');
+	}
+	boardJson.push_back(std::move(rowJson));
+	crow::json::wvalue matrix;
+	matrix["board"] = std::move(boardJson);
+	return matrix;
+}
+
+// Body of /bulletsCoord: bordered coordinates only
+crow::json::wvalue BoardSnapshot::GetBulletCoords() const
+{
+	crow::json::wvalue bulletsJson;
+	crow::json::wvalue::list bulletsList;
+	bulletsList.reserve(m_bullets.size());
+
+	for (const BulletState& bullet : m_bullets) {
+		crow::json::wvalue bulletJson;
+		bulletJson["coordX"] = bullet.x;
+		bulletJson["coordY"] = bullet.y;
+		bulletsList.push_back(std::move(bulletJson));
+	}
+
+	bulletsJson["bullets"] = std::move(bulletsList);
+	return bulletsJson;
+}
+
+// Full state plus the version it was taken at; clients apply deltas on top of it
+crow::json::wvalue BoardSnapshot::GetKeyframe() const
+{
+	crow::json::wvalue keyframe = GetBoardState();
+	crow::json::wvalue::list tanksJson;
+
+	for (size_t slot = 0; slot < m_tanks.size(); ++slot) {
+		crow::json::wvalue tankJson;
+		tankJson["slot"] = static_cast<int>(slot);
+		tankJson["x"] = m_tanks[slot].x;
+		tankJson["y"] = m_tanks[slot].y;
+		tankJson["direction"] = static_cast<int>(m_tanks[slot].direction);
+		tanksJson.push_back(std::move(tankJson));
+	}
+
+	keyframe["tanks"] = std::move(tanksJson);
+	keyframe["version"] = m_version;
+	keyframe["mapHash"] = mapgen::FormatHash(m_mapHash);
+	keyframe["keyframe"] = true;
+	return keyframe;
+}
+
+// Everything a client needs for one frame, all of it from this tick
+crow::json::wvalue BoardSnapshot::GetSnapshot(uint32_t fields, int gameTime) const
+{
+	trace::Scope serializationScope("serialization (snapshot)", "version", m_version);
+	crow::json::wvalue snapshot = (fields & SNAPSHOT_BOARD) ? GetBoardState() : crow::json::wvalue();
+	snapshot["version"] = m_version;
+	snapshot["tick"] = m_tick;
+	snapshot["mapHash"] = mapgen::FormatHash(m_mapHash);
+
+	if (fields & SNAPSHOT_TANKS) {
+		crow::json::wvalue::list tanksJson;
+		for (size_t slot = 0; slot < m_tanks.size(); ++slot) {
+			const TankState& tank = m_tanks[slot];
+			crow::json::wvalue tankJson;
+			tankJson["slot"] = static_cast<int>(slot);
+			tankJson["id"] = tank.id;
+			tankJson["x"] = tank.x;
+			tankJson["y"] = tank.y;
+			tankJson["direction"] = static_cast<int>(tank.direction);
+			tankJson["alive"] = tank.alive;
+			tankJson["lives"] = tank.lives;
+			tanksJson.push_back(std::move(tankJson));
+		}
+		snapshot["tanks"] = std::move(tanksJson);
+	}
+
+	if (fields & SNAPSHOT_BULLETS) {
+		crow::json::wvalue::list bulletsJson;
+		bulletsJson.reserve(m_bullets.size());
+		for (const BulletState& bullet : m_bullets) {
+			crow::json::wvalue bulletJson;
+			bulletJson["coordX"] = bullet.x;
+			bulletJson["coordY"] = bullet.y;
+			bulletJson["direction"] = static_cast<int>(bullet.direction);
+			bulletJson["owner"] = bullet.owner;
+			bulletsJson.push_back(std::move(bulletJson));
+		}
+		snapshot["bullets"] = std::move(bulletsJson);
+	}
+
+	if (fields & SNAPSHOT_SCORES) {
+		crow::json::wvalue::list scoresJson;
+		for (const TankState& tank : m_tanks) {
+			crow::json::wvalue scoreJson;
+			scoreJson["id"] = tank.id;
+			scoreJson["name"] = tank.name;
+			scoreJson["score"] = tank.score;
+			scoresJson.push_back(std::move(scoreJson));
+		}
+		snapshot["scores"] = std::move(scoresJson);
+	}
+
+	if (fields & SNAPSHOT_TIME) {
+		snapshot["time"] = gameTime;
+		snapshot["simulationTime"] = static_cast<double>(m_tick) / m_ticksPerSecond;
+	}
+
+	return snapshot;
+}
+
+// Binary counterpart of GetBoardState: 2-bit cells followed by one record per tank
+void BoardSnapshot::EncodeBoardState(std::string& out) const
+{
+	EncodeState(out, true, false);
+}
+
+// Binary counterpart of the /bulletsCoord listing
+void BoardSnapshot::EncodeBullets(std::string& out) const
+{
+	EncodeState(out, false, true);
+}
+
+// Cells, tanks and bullets in one message, as pushed to subscribers after every tick
+void BoardSnapshot::EncodeFrame(std::string& out) const
+{
+	EncodeState(out, true, true);
+}
+
+// Binary snapshot: board and tanks travel together, scores are not encoded and the time is the header tick
+void BoardSnapshot::EncodeSnapshot(std::string& out, uint32_t fields) const
+{
+	EncodeState(out, (fields & (SNAPSHOT_BOARD | SNAPSHOT_TANKS)) != 0, (fields & SNAPSHOT_BULLETS) != 0);
+}
+
+// Serialized full state, encoded once per state version and shared by every snapshot of that version.
+// Bullets are not part of it (they are served by /bulletsCoord), so bullet motion does not invalidate it.
+// The shared binary body carries the tick of whichever snapshot encoded it, so each copy handed out
+// gets this snapshot's tick written into its header.
+std::string BoardSnapshot::GetEncodedBoardState(bool binary) const
+{
+	if (binary) {
+		std::call_once(m_bodies->binaryOnce, [this]() {
+			trace::Scope serializationScope("serialization (state binary)", "version", m_version);
+			EncodeBoardState(m_bodies->binary);
+			});
+		std::string body = m_bodies->binary;
+		wire::SetTick(body, m_tick);
+		return body;
+	}
+
+	std::call_once(m_bodies->jsonOnce, [this]() {
+		trace::Scope serializationScope("serialization (state json)", "version", m_version);
+		crow::json::wvalue state = GetBoardState();
+		state["version"] = m_version;
+		m_bodies->json = state.dump();
+		});
+	return m_bodies->json;
+}
+
+// Entity tag for the full state; the epoch keeps tags from a previous board or server run from matching
+std::string BoardSnapshot::GetStateTag(bool binary) const
+{
+	return "\"" + std::to_string(m_epoch) + "-" + std::to_string(m_version) + (binary ? "-bin" : "") + "\"";
+}
+
+char BoardSnapshot::CellSymbol(int type)
+{
+	switch (type) {
+	case 1:
+		return '+'; // Breakable walls
+	case 2:
+		return '#'; // Unbreakable walls
+	default:
+		return ' ';
+	}
+}
+
+void BoardSnapshot::EncodeState(std::string& out, bool withBoard, bool withBullets) const
+{
+	size_t tankCount = withBoard ? m_tanks.size() : 0;
+	size_t bulletCount = withBullets ? m_bullets.size() : 0;
+	wire::Header header{ wire::FORMAT_VERSION, static_cast<uint8_t>(withBoard ? 2 : 0), static_cast<uint16_t>(m_height), static_cast<uint16_t>(m_width),
+		static_cast<uint16_t>(tankCount), static_cast<uint16_t>(bulletCount), m_tick };
+
+	out.clear();
+	out.reserve(wire::HEADER_SIZE + wire::CellBytes(header) + tankCount * wire::TANK_RECORD_SIZE + bulletCount * wire::BULLET_RECORD_SIZE);
+	wire::PutHeader(out, header);
+
+	if (withBoard) {
+		uint8_t packed = 0;
+		int shift = 0;
+		for (uint8_t type : *m_cells) {
+			wire::Cell cell = type == 1 ? wire::Cell::Breakable : type == 2 ? wire::Cell::Solid : wire::Cell::Empty;
+			packed |= static_cast<uint8_t>(cell) << shift;
+			shift += header.bitsPerCell;
+			if (shift == 8) {
+				out.push_back(static_cast<char>(packed));
+				packed = 0;
+				shift = 0;
+			}
+		}
+		if (shift != 0) {
+			out.push_back(static_cast<char>(packed));
+		}
+	}
+
+	for (size_t slot = 0; slot < tankCount; ++slot) {
+		const TankState& tank = m_tanks[slot];
+		wire::PutTank(out, wire::TankRecord{ static_cast<uint8_t>(slot), tank.direction, tank.lives, static_cast<uint8_t>(tank.alive),
+			static_cast<uint16_t>(tank.x), static_cast<uint16_t>(tank.y) });
+	}
+
+	for (size_t bullet = 0; bullet < bulletCount; ++bullet) {
+		const BulletState& state = m_bullets[bullet];
+		wire::PutBullet(out, wire::BulletRecord{ static_cast<uint16_t>(state.slot), state.owner, state.direction,
+			static_cast<float>(state.x), static_cast<float>(state.y) });
+	}
+}
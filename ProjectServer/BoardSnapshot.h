@@ -0,0 +1,99 @@
+#pragma once
+#include <crow.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Sections of a snapshot, combined as a bit mask
+enum SnapshotField : uint32_t {
+    SNAPSHOT_BOARD = 1 << 0,
+    SNAPSHOT_TANKS = 1 << 1,
+    SNAPSHOT_BULLETS = 1 << 2,
+    SNAPSHOT_SCORES = 1 << 3,
+    SNAPSHOT_TIME = 1 << 4,
+    SNAPSHOT_ALL = SNAPSHOT_BOARD | SNAPSHOT_TANKS | SNAPSHOT_BULLETS | SNAPSHOT_SCORES | SNAPSHOT_TIME
+};
+
+struct TankState {
+    int id;
+    std::string name;
+    int x; // row
+    int y; // column
+    uint8_t direction;
+    bool alive;
+    uint8_t lives;
+    int score;
+};
+
+struct BulletState {
+    uint32_t slot;
+    uint8_t owner;
+    uint8_t direction;
+    double x; // bordered column
+    double y; // bordered row
+};
+
+// Copy of a board taken by its simulation thread at the end of a tick. It is never
+// modified once published, so any number of request threads can read and serialize
+// it without the room's state lock while the next tick runs. Snapshots of the same
+// state version share their cells and their encoded bodies; each body is encoded by
+// the first reader that asks for it.
+class BoardSnapshot
+{
+private:
+    friend class Board; // fills the snapshot before publishing it
+
+    struct EncodedBodies {
+        std::once_flag jsonOnce;
+        std::once_flag binaryOnce;
+        std::string json;
+        std::string binary;
+    };
+
+    // Member Variables
+    uint64_t m_tick = 0;
+    uint64_t m_version = 0;
+    int64_t m_epoch = 0;
+    uint64_t m_mapHash = 0; // the walls as generated, fetchable once from /map/<hash>
+    int m_height = 0;
+    int m_width = 0;
+    int m_ticksPerSecond = 0;
+    bool m_full = false;
+    std::shared_ptr<const std::vector<uint8_t>> m_cells; // row-major cell codes
+    std::vector<TankState> m_tanks;                       // indexed by slot
+    std::vector<BulletState> m_bullets;
+    std::shared_ptr<EncodedBodies> m_bodies;
+
+public:
+    // Getters
+    uint64_t GetTick() const;
+    uint64_t GetVersion() const;
+    uint64_t GetMapHash() const;
+    int GetHeight() const;
+    int GetWidth() const;
+    const std::vector<TankState>& GetTanks() const;
+    const std::vector<BulletState>& GetBullets() const;
+    bool HasPlayer(int playerId) const;
+    bool IsFull() const;
+
+    // Serializing
+    crow::json::wvalue GetPlayerState() const;
+    crow::json::wvalue GetBoardState() const;
+    crow::json::wvalue GetBulletCoords() const;
+    crow::json::wvalue GetKeyframe() const;
+    crow::json::wvalue GetSnapshot(uint32_t fields, int gameTime) const;
+    void EncodeBoardState(std::string& out) const;
+    void EncodeBullets(std::string& out) const;
+    void EncodeFrame(std::string& out) const;
+    void EncodeSnapshot(std::string& out, uint32_t fields) const;
+    std::string GetEncodedBoardState(bool binary) const;
+    std::string GetStateTag(bool binary) const;
+
+    static char CellSymbol(int type);
+
+private:
+    // Helper Functions
+    void EncodeState(std::string& out, bool withBoard, bool withBullets) const;
+};
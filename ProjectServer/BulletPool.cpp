@@ -0,0 +1,167 @@
+#include "BulletPool.h"
+
+BulletPool::BulletPool(size_t capacity)
+	: m_coordX(capacity),
+	m_coordY(capacity),
+	m_direction(capacity),
+	m_speed(capacity),
+	m_owner(capacity),
+	m_active(capacity),
+	m_denseToSlot(capacity),
+	m_slotToDense(capacity),
+	m_generation(capacity, 0),
+	m_size(0)
+{
+	m_freeSlots.reserve(capacity);
+	for (size_t slot = capacity; slot > 0; --slot) {
+		m_freeSlots.push_back(static_cast<uint32_t>(slot - 1));
+	}
+}
+
+std::optional<BulletHandle> BulletPool::Spawn(double x, double y, Direction direction, double speed, uint8_t owner)
+{
+	if (m_freeSlots.empty()) {
+		return std::nullopt; // pool exhausted, the shot is dropped
+	}
+
+	uint32_t slot = m_freeSlots.back();
+	m_freeSlots.pop_back();
+
+	size_t index = m_size++;
+	m_coordX[index] = x;
+	m_coordY[index] = y;
+	m_direction[index] = direction;
+	m_speed[index] = speed;
+	m_owner[index] = owner;
+	m_active[index] = true;
+	m_denseToSlot[index] = slot;
+	m_slotToDense[slot] = static_cast<uint32_t>(index);
+
+	return BulletHandle{ slot, m_generation[slot] };
+}
+
+bool BulletPool::Despawn(BulletHandle handle)
+{
+	auto index = IndexOf(handle);
+	if (!index) {
+		return false;
+	}
+	DespawnAt(*index);
+	return true;
+}
+
+// Swap-removes the bullet so the live range stays contiguous
+void BulletPool::DespawnAt(size_t index)
+{
+	size_t last = m_size - 1;
+	uint32_t slot = m_denseToSlot[index];
+
+	if (index != last) {
+		m_coordX[index] = m_coordX[last];
+		m_coordY[index] = m_coordY[last];
+		m_direction[index] = m_direction[last];
+		m_speed[index] = m_speed[last];
+		m_owner[index] = m_owner[last];
+		m_active[index] = m_active[last];
+		m_denseToSlot[index] = m_denseToSlot[last];
+		m_slotToDense[m_denseToSlot[index]] = static_cast<uint32_t>(index);
+	}
+
+	++m_generation[slot];
+	m_freeSlots.push_back(slot);
+	--m_size;
+}
+
+void BulletPool::RemoveInactive()
+{
+	for (size_t index = m_size; index > 0; --index) {
+		if (!m_active[index - 1]) {
+			DespawnAt(index - 1);
+		}
+	}
+}
+
+void BulletPool::Clear()
+{
+	while (m_size > 0) {
+		DespawnAt(m_size - 1);
+	}
+}
+
+bool BulletPool::IsValid(BulletHandle handle) const
+{
+	return handle.slot < m_generation.size() &&
+		m_generation[handle.slot] == handle.generation &&
+		m_slotToDense[handle.slot] < m_size &&
+		m_denseToSlot[m_slotToDense[handle.slot]] == handle.slot;
+}
+
+std::optional<size_t> BulletPool::IndexOf(BulletHandle handle) const
+{
+	if (!IsValid(handle)) {
+		return std::nullopt;
+	}
+	return m_slotToDense[handle.slot];
+}
+
+BulletHandle BulletPool::HandleAt(size_t index) const
+{
+	uint32_t slot = m_denseToSlot[index];
+	return BulletHandle{ slot, m_generation[slot] };
+}
+
+size_t BulletPool::Size() const
+{
+	return m_size;
+}
+
+size_t BulletPool::Capacity() const
+{
+	return m_generation.size();
+}
+
+double BulletPool::GetX(size_t index) const
+{
+	return m_coordX[index];
+}
+
+double BulletPool::GetY(size_t index) const
+{
+	return m_coordY[index];
+}
+
+Direction BulletPool::GetDirection(size_t index) const
+{
+	return m_direction[index];
+}
+
+double BulletPool::GetSpeed(size_t index) const
+{
+	return m_speed[index];
+}
+
+uint8_t BulletPool::GetOwner(size_t index) const
+{
+	return m_owner[index];
+}
+
+bool BulletPool::IsActive(size_t index) const
+{
+	return m_active[index];
+}
+
+void BulletPool::SetX(size_t index, double x)
+{
+	m_coordX[index] = x;
+}
+
+void BulletPool::SetY(size_t index, double y)
+{
+	m_coordY[index] = y;
+}
+
+void BulletPool::Destroy(size_t index)
+{
+	m_active[index] = false;
+	m_speed[index] = 0;
+}
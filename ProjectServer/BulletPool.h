@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+import Direction;
+
+// Stable reference to a pooled bullet; stale once the slot is reused
+struct BulletHandle {
+    uint32_t slot;
+    uint32_t generation;
+};
+
+// Fixed-capacity bullet storage laid out as struct-of-arrays.
+// Live bullets are kept densely packed in [0, Size()) so per-tick passes walk
+// contiguous arrays; handles go through a slot table so they survive compaction.
+class BulletPool {
+private:
+    // Member Variables (dense, indexed by position)
+    std::vector<double> m_coordX;
+    std::vector<double> m_coordY;
+    std::vector<Direction> m_direction;
+    std::vector<double> m_speed; // cells per second
+    std::vector<uint8_t> m_owner;
+    std::vector<uint8_t> m_active;
+    std::vector<uint32_t> m_denseToSlot;
+
+    // Member Variables (sparse, indexed by slot)
+    std::vector<uint32_t> m_slotToDense;
+    std::vector<uint32_t> m_generation;
+    std::vector<uint32_t> m_freeSlots;
+
+    size_t m_size;
+
+public:
+    // Constructor and Destructor
+    explicit BulletPool(size_t capacity);
+    ~BulletPool() = default;
+
+    // Spawning and Despawning
+    std::optional<BulletHandle> Spawn(double x, double y, Direction direction, double speed, uint8_t owner);
+    bool Despawn(BulletHandle handle);
+    void DespawnAt(size_t index);
+    void RemoveInactive();
+    void Clear();
+
+    // Handles
+    bool IsValid(BulletHandle handle) const;
+    std::optional<size_t> IndexOf(BulletHandle handle) const;
+    BulletHandle HandleAt(size_t index) const;
+
+    // Getters (by dense index)
+    size_t Size() const;
+    size_t Capacity() const;
+    double GetX(size_t index) const;
+    double GetY(size_t index) const;
+    Direction GetDirection(size_t index) const;
+    double GetSpeed(size_t index) const;
+    uint8_t GetOwner(size_t index) const;
+    bool IsActive(size_t index) const;
+
+    // Setters (by dense index)
+    void SetX(size_t index, double x);
+    void SetY(size_t index, double y);
+    void Destroy(size_t index);
+};
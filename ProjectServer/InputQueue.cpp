@@ -0,0 +1,97 @@
+#include "InputQueue.h"
+
+namespace {
+	int64_t SteadyNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+InputQueue::InputQueue(size_t capacity)
+	: m_commands(capacity),
+	m_enqueued(0),
+	m_dropped(0),
+	m_applied(0),
+	m_lastLatency(0),
+	m_maxLatency(0),
+	m_totalLatency(0)
+{
+}
+
+// Lock-free for any number of producers; returns false (and counts a drop) when the queue is full
+bool InputQueue::Push(InputCommand command)
+{
+	command.enqueuedAt = SteadyNanoseconds();
+	bool queued = m_commands.TryPush([&command](InputCommand& slot) {
+		slot = std::move(command);
+		});
+	if (!queued) {
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	m_enqueued.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+// Simulation thread only; the latency is measured here since the input is applied right after
+bool InputQueue::Pop(InputCommand& command)
+{
+	if (!m_commands.TryPop(command)) {
+		return false;
+	}
+
+	int64_t latency = SteadyNanoseconds() - command.enqueuedAt;
+	m_lastLatency.store(latency, std::memory_order_relaxed);
+	if (latency > m_maxLatency.load(std::memory_order_relaxed)) {
+		m_maxLatency.store(latency, std::memory_order_relaxed);
+	}
+	m_totalLatency.fetch_add(latency, std::memory_order_relaxed);
+	m_applied.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+size_t InputQueue::GetCapacity() const
+{
+	return m_commands.GetCapacity();
+}
+
+size_t InputQueue::GetDepth() const
+{
+	return m_commands.GetDepth();
+}
+
+uint64_t InputQueue::GetEnqueuedCount() const
+{
+	return m_enqueued.load(std::memory_order_relaxed);
+}
+
+uint64_t InputQueue::GetDroppedCount() const
+{
+	return m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t InputQueue::GetAppliedCount() const
+{
+	return m_applied.load(std::memory_order_relaxed);
+}
+
+int64_t InputQueue::GetLastLatency() const
+{
+	return m_lastLatency.load(std::memory_order_relaxed) / 1000;
+}
+
+int64_t InputQueue::GetMaxLatency() const
+{
+	return m_maxLatency.load(std::memory_order_relaxed) / 1000;
+}
+
+int64_t InputQueue::GetMeanLatency() const
+{
+	uint64_t applied = m_applied.load(std::memory_order_relaxed);
+	if (applied == 0) {
+		return 0;
+	}
+	return m_totalLatency.load(std::memory_order_relaxed) / static_cast<int64_t>(applied) / 1000;
+}
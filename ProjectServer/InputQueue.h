@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "MpscRing.h"
+
+enum class InputType : uint8_t { Move, Shoot, Join };
+
+// One validated player input waiting for the simulation thread
+struct InputCommand {
+    InputType type = InputType::Move;
+    int playerId = 0;     // persistent player id; Move and Shoot map it to a slot through SlotTable
+    char key = 0;         // Move only
+    int highScore = 0;    // Join only
+    uint8_t lives = 0;    // Join only
+    std::string name;     // Join only; left empty otherwise so moves and shots never allocate
+    int64_t enqueuedAt = 0; // steady clock, nanoseconds
+};
+
+// Inputs from request handlers on their way to a room's simulation thread. Any number
+// of handlers push without taking the state lock; the simulation thread pops them at
+// the start of the next tick. A full queue rejects the input and counts a drop.
+class InputQueue
+{
+private:
+    // Member Variables
+    MpscRing<InputCommand> m_commands;
+    std::atomic<uint64_t> m_enqueued;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_applied;
+    std::atomic<int64_t> m_lastLatency;  // nanoseconds from Push to Pop
+    std::atomic<int64_t> m_maxLatency;   // nanoseconds
+    std::atomic<int64_t> m_totalLatency; // nanoseconds, over every applied input
+
+public:
+    // Constructor and Destructor
+    explicit InputQueue(size_t capacity);
+    ~InputQueue() = default;
+
+    // Queueing
+    bool Push(InputCommand command);
+    bool Pop(InputCommand& command);
+
+    // Getters
+    size_t GetCapacity() const;
+    size_t GetDepth() const;
+    uint64_t GetEnqueuedCount() const;
+    uint64_t GetDroppedCount() const;
+    uint64_t GetAppliedCount() const;
+    int64_t GetLastLatency() const; // microseconds
+    int64_t GetMaxLatency() const;  // microseconds
+    int64_t GetMeanLatency() const; // microseconds
+};
@@ -0,0 +1,146 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+	: m_counts(std::make_unique<std::atomic<uint64_t>[]>(BUCKET_COUNT)),
+	m_sum(0),
+	m_max(0)
+{
+}
+
+void LatencyHistogram::Record(uint64_t micros)
+{
+	m_counts[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+	if (micros != 0) {
+		m_sum.fetch_add(micros, std::memory_order_relaxed);
+	}
+
+	// Only a new maximum writes the shared word, which is rare once the histogram has warmed up
+	uint64_t max = m_max.load(std::memory_order_relaxed);
+	while (micros > max && !m_max.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {
+	}
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+	for (size_t index = 0; index < BUCKET_COUNT; ++index) {
+		if (uint64_t count = other.m_counts[index].load(std::memory_order_relaxed)) {
+			m_counts[index].fetch_add(count, std::memory_order_relaxed);
+		}
+	}
+	m_sum.fetch_add(other.GetSum(), std::memory_order_relaxed);
+
+	uint64_t otherMax = other.GetMax();
+	uint64_t max = m_max.load(std::memory_order_relaxed);
+	while (otherMax > max && !m_max.compare_exchange_weak(max, otherMax, std::memory_order_relaxed)) {
+	}
+}
+
+// The count is the sum of the buckets rather than a counter of its own, so recording touches one less shared word
+uint64_t LatencyHistogram::GetCount() const
+{
+	uint64_t total = 0;
+	for (size_t index = 0; index < BUCKET_COUNT; ++index) {
+		total += m_counts[index].load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+uint64_t LatencyHistogram::GetSum() const
+{
+	return m_sum.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetMax() const
+{
+	return m_max.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetMean() const
+{
+	uint64_t total = GetCount();
+	return total ? static_cast<double>(GetSum()) / total : 0.0;
+}
+
+// Smallest recorded bucket with at least percentile% of the values at or below it
+uint64_t LatencyHistogram::GetPercentile(double percentile) const
+{
+	std::vector<uint64_t> counts = LoadCounts();
+	uint64_t total = 0;
+	for (uint64_t count : counts) {
+		total += count;
+	}
+	if (total == 0) {
+		return 0;
+	}
+
+	uint64_t max = GetMax();
+	uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total));
+	rank = std::clamp<uint64_t>(rank, 1, total);
+	uint64_t seen = 0;
+	for (size_t index = 0; index < counts.size(); ++index) {
+		seen += counts[index];
+		if (seen >= rank) {
+			// The last bucket also holds everything beyond the range
+			return index + 1 == counts.size() ? max : std::min(BucketValue(index), max);
+		}
+	}
+	return max;
+}
+
+// Values at or below each bound, for exporting as cumulative buckets; the last element is the total.
+// A bound inside a bucket counts that whole bucket, which is at most 1% off like the percentiles.
+std::vector<uint64_t> LatencyHistogram::GetCumulativeCounts(std::span<const uint64_t> bounds) const
+{
+	std::vector<uint64_t> cumulative;
+	cumulative.reserve(bounds.size() + 1);
+
+	uint64_t seen = 0;
+	size_t bound = 0;
+	for (size_t index = 0; index < BUCKET_COUNT; ++index) {
+		while (bound < bounds.size() && index == BucketIndex(bounds[bound]) + 1) {
+			cumulative.push_back(seen);
+			++bound;
+		}
+		seen += m_counts[index].load(std::memory_order_relaxed);
+	}
+	while (cumulative.size() < bounds.size() + 1) {
+		cumulative.push_back(seen);
+	}
+	return cumulative;
+}
+
+std::vector<uint64_t> LatencyHistogram::LoadCounts() const
+{
+	std::vector<uint64_t> counts(BUCKET_COUNT);
+	for (size_t index = 0; index < BUCKET_COUNT; ++index) {
+		counts[index] = m_counts[index].load(std::memory_order_relaxed);
+	}
+	return counts;
+}
+
+// Bucket 0..SUB_BUCKETS-1 holds the value itself; above that every power of two gets SUB_BUCKETS buckets
+size_t LatencyHistogram::BucketIndex(uint64_t micros)
+{
+	if (micros < SUB_BUCKETS) {
+		return static_cast<size_t>(micros);
+	}
+
+	int shift = std::min(static_cast<int>(std::bit_width(micros)) - (SUB_BUCKET_BITS + 1), MAX_SHIFT);
+	uint64_t step = std::min<uint64_t>(micros >> shift, 2 * SUB_BUCKETS - 1);
+	return static_cast<size_t>(SUB_BUCKETS) * (shift + 1) + (step - SUB_BUCKETS);
+}
+
+// Highest value that lands in the bucket, so percentiles never read low
+uint64_t LatencyHistogram::BucketValue(size_t index)
+{
+	if (index < SUB_BUCKETS) {
+		return index;
+	}
+
+	int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+	uint64_t step = index % SUB_BUCKETS + SUB_BUCKETS;
+	return ((step + 1) << shift) - 1;
+}
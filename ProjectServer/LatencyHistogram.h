@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Log-linear histogram of latencies in microseconds, in the spirit of HdrHistogram:
+// values below 2^SUB_BUCKET_BITS are counted exactly, larger ones fall into one of
+// 2^SUB_BUCKET_BITS linear steps of their power of two. Any percentile is therefore
+// within 1% of the true value and the whole table is a few dozen KB however long the
+// run. Recording is an index computation and relaxed atomic adds, so any number of
+// threads can record into one histogram without a lock; readers see a consistent
+// enough picture for monitoring, not an exact cut.
+class LatencyHistogram
+{
+private:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_SHIFT = 32; // up to ~2^39 us, far beyond any request timeout
+    static constexpr size_t BUCKET_COUNT = static_cast<size_t>(SUB_BUCKETS) * (MAX_SHIFT + 2);
+
+    // Member Variables
+    std::unique_ptr<std::atomic<uint64_t>[]> m_counts;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+
+public:
+    // Constructor and Destructor
+    LatencyHistogram();
+    ~LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Recording
+    void Record(uint64_t micros);
+    void Merge(const LatencyHistogram& other);
+
+    // Getters
+    uint64_t GetCount() const;
+    uint64_t GetSum() const;
+    uint64_t GetMax() const;
+    double GetMean() const;
+    uint64_t GetPercentile(double percentile) const; // percentile in [0, 100]
+    std::vector<uint64_t> GetCumulativeCounts(std::span<const uint64_t> bounds) const; // ascending bounds, then the total
+
+private:
+    // Helper Functions
+    std::vector<uint64_t> LoadCounts() const;
+    static size_t BucketIndex(uint64_t micros);
+    static uint64_t BucketValue(size_t index);
+};
@@ -0,0 +1,335 @@
+#include "MapCache.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+	const uint32_t FILE_MAGIC = 0x504D4B54; // "TKMP"
+	const uint16_t FILE_VERSION = 1;
+	const size_t FILE_HEADER_SIZE = 15;
+	const auto STALE_TEMPORARY_AGE = std::chrono::minutes(1); // younger ones may still be written by a server sharing the directory
+
+	template<typename T>
+	void Write(char*& out, T value)
+	{
+		for (size_t byte = 0; byte < sizeof(T); ++byte) {
+			*out++ = static_cast<char>((static_cast<uint64_t>(value) >> (byte * 8)) & 0xFF);
+		}
+	}
+
+	template<typename T>
+	T Read(const char*& in)
+	{
+		uint64_t value = 0;
+		for (size_t byte = 0; byte < sizeof(T); ++byte) {
+			value |= static_cast<uint64_t>(static_cast<uint8_t>(*in++)) << (byte * 8);
+		}
+		return static_cast<T>(value);
+	}
+
+	bool Matches(const mapgen::Map& map, uint32_t seed, int height, int width, int difficulty)
+	{
+		return map.seed == seed && map.height == height && map.width == width && map.difficulty == difficulty;
+	}
+}
+
+MapCache::MapCache(size_t capacityBytes, const std::string& directory, size_t diskCapacityBytes)
+	: m_bytes(0),
+	m_capacityBytes(capacityBytes),
+	m_directory(directory),
+	m_diskBytes(0),
+	m_diskCapacityBytes(diskCapacityBytes),
+	m_memoryHits(0),
+	m_diskHits(0),
+	m_misses(0),
+	m_evictions(0)
+{
+	if (!m_directory.empty()) {
+		std::filesystem::create_directories(m_directory);
+		LoadDiskIndex();
+	}
+}
+
+// The map for these inputs, from memory, then disk, then generated here
+std::shared_ptr<const mapgen::Map> MapCache::Get(uint32_t seed, int height, int width, int difficulty)
+{
+	uint64_t hash = mapgen::Hash(seed, height, width, difficulty);
+
+	// A hash collision is possible in theory; such an entry is ignored rather than served
+	std::shared_ptr<const mapgen::Map> map = FindInMemory(hash);
+	if (map && Matches(*map, seed, height, width, difficulty)) {
+		m_memoryHits.fetch_add(1, std::memory_order_relaxed);
+		return map;
+	}
+
+	map = ReadFromDisk(hash);
+	if (map && Matches(*map, seed, height, width, difficulty)) {
+		m_diskHits.fetch_add(1, std::memory_order_relaxed);
+		return Remember(std::move(map));
+	}
+
+	m_misses.fetch_add(1, std::memory_order_relaxed);
+	map = std::make_shared<const mapgen::Map>(mapgen::Generate(seed, height, width, difficulty));
+	WriteToDisk(*map);
+	return Remember(std::move(map));
+}
+
+// Null when the map is neither in memory nor on disk
+std::shared_ptr<const mapgen::Map> MapCache::Find(uint64_t hash)
+{
+	if (std::shared_ptr<const mapgen::Map> map = FindInMemory(hash)) {
+		m_memoryHits.fetch_add(1, std::memory_order_relaxed);
+		return map;
+	}
+
+	if (std::shared_ptr<const mapgen::Map> map = ReadFromDisk(hash)) {
+		m_diskHits.fetch_add(1, std::memory_order_relaxed);
+		return Remember(std::move(map));
+	}
+	return nullptr;
+}
+
+// Adds a map generated elsewhere (a pooled one) to memory only; returns the copy the cache holds.
+// Its seed was random, so nobody asks for it by seed again once the rooms using it are gone.
+std::shared_ptr<const mapgen::Map> MapCache::Insert(mapgen::Map map)
+{
+	if (std::shared_ptr<const mapgen::Map> cached = FindInMemory(map.hash)) {
+		return cached;
+	}
+	return Remember(std::make_shared<const mapgen::Map>(std::move(map)));
+}
+
+size_t MapCache::GetCapacityBytes() const
+{
+	return m_capacityBytes;
+}
+
+size_t MapCache::GetSizeBytes() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_bytes;
+}
+
+size_t MapCache::GetMapCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.size();
+}
+
+bool MapCache::HasDiskTier() const
+{
+	return !m_directory.empty();
+}
+
+size_t MapCache::GetDiskCapacityBytes() const
+{
+	return m_diskCapacityBytes;
+}
+
+size_t MapCache::GetDiskSizeBytes() const
+{
+	std::lock_guard<std::mutex> lock(m_diskMutex);
+	return m_diskBytes;
+}
+
+uint64_t MapCache::GetMemoryHitCount() const
+{
+	return m_memoryHits.load(std::memory_order_relaxed);
+}
+
+uint64_t MapCache::GetDiskHitCount() const
+{
+	return m_diskHits.load(std::memory_order_relaxed);
+}
+
+uint64_t MapCache::GetMissCount() const
+{
+	return m_misses.load(std::memory_order_relaxed);
+}
+
+uint64_t MapCache::GetEvictionCount() const
+{
+	return m_evictions.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<const mapgen::Map> MapCache::FindInMemory(uint64_t hash)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(hash);
+	if (it == m_entries.end()) {
+		return nullptr;
+	}
+	m_recency.splice(m_recency.begin(), m_recency, it->second.position);
+	return it->second.map;
+}
+
+// Keeps the map that is already resident when another thread got there first.
+// The newest map always stays, even when it alone is over the budget.
+std::shared_ptr<const mapgen::Map> MapCache::Remember(std::shared_ptr<const mapgen::Map> map)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(map->hash);
+	if (it != m_entries.end()) {
+		m_recency.splice(m_recency.begin(), m_recency, it->second.position);
+		return it->second.map;
+	}
+
+	m_recency.push_front(map->hash);
+	m_entries.emplace(map->hash, Entry{ map, m_recency.begin() });
+	m_bytes += map->cells.size();
+
+	while (m_bytes > m_capacityBytes && m_entries.size() > 1) {
+		auto oldest = m_entries.find(m_recency.back());
+		m_bytes -= oldest->second.map->cells.size();
+		m_entries.erase(oldest);
+		m_recency.pop_back();
+		m_evictions.fetch_add(1, std::memory_order_relaxed);
+	}
+	return map;
+}
+
+// Null when there is no disk tier, no file, or the file is truncated or does not match its name
+std::shared_ptr<const mapgen::Map> MapCache::ReadFromDisk(uint64_t hash)
+{
+	if (m_directory.empty()) {
+		return nullptr;
+	}
+
+	std::ifstream file(PathFor(hash), std::ios_base::binary);
+	char header[FILE_HEADER_SIZE];
+	if (!file.read(header, sizeof(header))) {
+		return nullptr;
+	}
+
+	const char* in = header;
+	if (Read<uint32_t>(in) != FILE_MAGIC || Read<uint16_t>(in) != FILE_VERSION) {
+		return nullptr;
+	}
+
+	mapgen::Map map;
+	map.seed = Read<uint32_t>(in);
+	map.height = Read<uint16_t>(in);
+	map.width = Read<uint16_t>(in);
+	map.difficulty = Read<uint8_t>(in);
+	map.hash = mapgen::Hash(map.seed, map.height, map.width, map.difficulty);
+	if (map.hash != hash) {
+		return nullptr;
+	}
+
+	map.cells.resize(static_cast<size_t>(map.height) * map.width);
+	if (!file.read(reinterpret_cast<char*>(map.cells.data()), static_cast<std::streamsize>(map.cells.size()))) {
+		return nullptr;
+	}
+	TouchOnDisk(hash, FILE_HEADER_SIZE + map.cells.size());
+	return std::make_shared<const mapgen::Map>(std::move(map));
+}
+
+// Written under a temporary name (per thread) and renamed, so readers never see half a file
+void MapCache::WriteToDisk(const mapgen::Map& map)
+{
+	if (m_directory.empty()) {
+		return;
+	}
+
+	std::filesystem::path path = PathFor(map.hash);
+	std::error_code error;
+	if (std::filesystem::exists(path, error)) {
+		return;
+	}
+
+	std::filesystem::path temporary = path;
+	temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios_base::binary | std::ios_base::trunc);
+		char header[FILE_HEADER_SIZE];
+		char* out = header;
+		Write(out, FILE_MAGIC);
+		Write(out, FILE_VERSION);
+		Write(out, map.seed);
+		Write(out, static_cast<uint16_t>(map.height));
+		Write(out, static_cast<uint16_t>(map.width));
+		Write(out, static_cast<uint8_t>(map.difficulty));
+		file.write(header, sizeof(header));
+		file.write(reinterpret_cast<const char*>(map.cells.data()), static_cast<std::streamsize>(map.cells.size()));
+		if (!file) {
+			file.close();
+			std::filesystem::remove(temporary, error);
+			return;
+		}
+	}
+	std::filesystem::rename(temporary, path, error);
+	if (!error) {
+		TouchOnDisk(map.hash, FILE_HEADER_SIZE + map.cells.size());
+	}
+}
+
+// Indexes the files already in the directory, oldest first so the last written ends up most recent, and trims them to the budget.
+// Temporary files a crash left behind are deleted; nothing else would ever remove them or count them against the budget.
+void MapCache::LoadDiskIndex()
+{
+	std::vector<std::pair<std::filesystem::file_time_type, std::pair<uint64_t, size_t>>> files;
+	std::vector<std::filesystem::path> staleTemporaries;
+	std::error_code error;
+	auto staleBefore = std::filesystem::file_time_type::clock::now() - STALE_TEMPORARY_AGE;
+	for (const auto& file : std::filesystem::directory_iterator(m_directory, error)) {
+		if (file.path().extension() == ".tmp") {
+			if (file.last_write_time(error) < staleBefore && !error) {
+				staleTemporaries.push_back(file.path());
+			}
+			continue;
+		}
+
+		std::string stem = file.path().stem().string();
+		uint64_t hash = 0;
+		auto [end, parseError] = std::from_chars(stem.data(), stem.data() + stem.size(), hash, 16);
+		if (file.path().extension() != ".map" || parseError != std::errc() || end != stem.data() + stem.size()) {
+			continue;
+		}
+		files.emplace_back(file.last_write_time(error), std::make_pair(hash, static_cast<size_t>(file.file_size(error))));
+	}
+	std::sort(files.begin(), files.end());
+
+	for (const std::filesystem::path& temporary : staleTemporaries) {
+		std::filesystem::remove(temporary, error);
+	}
+	for (const auto& [time, file] : files) {
+		TouchOnDisk(file.first, file.second);
+	}
+}
+
+// Moves the file to the front of the disk index (adding it if new), then deletes the least
+// recently used files until the directory is back within budget. The newest file always stays.
+void MapCache::TouchOnDisk(uint64_t hash, size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_diskMutex);
+	auto it = m_diskEntries.find(hash);
+	if (it != m_diskEntries.end()) {
+		m_diskRecency.splice(m_diskRecency.begin(), m_diskRecency, it->second.position);
+		return;
+	}
+
+	m_diskRecency.push_front(hash);
+	m_diskEntries.emplace(hash, DiskEntry{ bytes, m_diskRecency.begin() });
+	m_diskBytes += bytes;
+
+	std::error_code error;
+	while (m_diskBytes > m_diskCapacityBytes && m_diskEntries.size() > 1) {
+		uint64_t oldest = m_diskRecency.back();
+		std::filesystem::remove(PathFor(oldest), error);
+		if (error) {
+			break; // still open somewhere; tried again on the next write
+		}
+		m_diskBytes -= m_diskEntries[oldest].bytes;
+		m_diskEntries.erase(oldest);
+		m_diskRecency.pop_back();
+	}
+}
+
+std::filesystem::path MapCache::PathFor(uint64_t hash) const
+{
+	return m_directory / (mapgen::FormatHash(hash) + ".map");
+}
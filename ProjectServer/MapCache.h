@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "MapGenerator.h"
+
+// Generated maps by hash (see mapgen::Hash), least recently used first out once the
+// cells held in memory pass the byte budget. With a directory the cache also keeps the
+// maps asked for by seed on disk, one file per hash, so a restarted server or another
+// one sharing the directory does not regenerate them; pooled maps come from random
+// seeds and stay in memory only. The disk tier has a byte budget of its own, with the
+// least recently used files deleted first, and is best effort: a map that cannot be
+// written is simply not on disk.
+//
+// File layout (little-endian): magic u32, file version u16, seed u32, height u16,
+// width u16, difficulty u8, then height * width cell bytes, row-major.
+class MapCache
+{
+private:
+    struct Entry {
+        std::shared_ptr<const mapgen::Map> map;
+        std::list<uint64_t>::iterator position;
+    };
+
+    struct DiskEntry {
+        size_t bytes;
+        std::list<uint64_t>::iterator position;
+    };
+
+    // Member Variables
+    mutable std::mutex m_mutex;
+    std::list<uint64_t> m_recency; // most recently used first
+    std::unordered_map<uint64_t, Entry> m_entries;
+    size_t m_bytes;
+    size_t m_capacityBytes;
+    std::filesystem::path m_directory; // empty when there is no disk tier
+    mutable std::mutex m_diskMutex;    // guards the disk index; never held together with m_mutex
+    std::list<uint64_t> m_diskRecency; // files by last use, most recent first
+    std::unordered_map<uint64_t, DiskEntry> m_diskEntries;
+    size_t m_diskBytes;
+    size_t m_diskCapacityBytes;
+    std::atomic<uint64_t> m_memoryHits;
+    std::atomic<uint64_t> m_diskHits;
+    std::atomic<uint64_t> m_misses;
+    std::atomic<uint64_t> m_evictions;
+
+public:
+    // Constructor and Destructor
+    MapCache(size_t capacityBytes, const std::string& directory, size_t diskCapacityBytes);
+    ~MapCache() = default;
+
+    // Maps
+    std::shared_ptr<const mapgen::Map> Get(uint32_t seed, int height, int width, int difficulty);
+    std::shared_ptr<const mapgen::Map> Find(uint64_t hash);
+    std::shared_ptr<const mapgen::Map> Insert(mapgen::Map map);
+
+    // Getters
+    size_t GetCapacityBytes() const;
+    size_t GetSizeBytes() const;
+    size_t GetMapCount() const;
+    bool HasDiskTier() const;
+    size_t GetDiskCapacityBytes() const;
+    size_t GetDiskSizeBytes() const;
+    uint64_t GetMemoryHitCount() const;
+    uint64_t GetDiskHitCount() const;
+    uint64_t GetMissCount() const;
+    uint64_t GetEvictionCount() const;
+
+private:
+    // Helper Functions
+    std::shared_ptr<const mapgen::Map> FindInMemory(uint64_t hash);
+    std::shared_ptr<const mapgen::Map> Remember(std::shared_ptr<const mapgen::Map> map);
+    std::shared_ptr<const mapgen::Map> ReadFromDisk(uint64_t hash);
+    void WriteToDisk(const mapgen::Map& map);
+    void LoadDiskIndex();
+    void TouchOnDisk(uint64_t hash, size_t bytes);
+    std::filesystem::path PathFor(uint64_t hash) const;
+};
@@ -0,0 +1,147 @@
+#include "MapGenerator.h"
+#include <random>
+#include <stdexcept>
+#include "ReachabilityValidator.h"
+#include "SolidWallFixer.h"
+
+namespace {
+	const int SOLID_BLOCK_SIZE = 3; // no k x k block of solid walls survives generation, so no larger one does either
+	const int MAX_GENERATION_ATTEMPTS = 16; // rejected layouts before the spawn corners are joined by hand
+
+	void FillCells(std::vector<uint8_t>& cells, std::mt19937& random, int difficulty)
+	{
+		int zeroPercent, onePercent, twoPercent, bombPercent;
+		mapgen::SetPercentages(difficulty, zeroPercent, onePercent, twoPercent, bombPercent);
+
+		std::uniform_int_distribution<int> percent(0, 99);
+		int maxBombs = 3 + difficulty;
+		int currentBombs = 0;
+
+		for (uint8_t& cell : cells) {
+			int random_value = percent(random); // Generates a random number between 0 and 99
+			if (random_value < zeroPercent) {
+				cell = 0; // Zeroes
+			}
+			else if (random_value < zeroPercent + onePercent) {
+				cell = 1; // Ones
+			}
+			else if (random_value < zeroPercent + onePercent + twoPercent) {
+				cell = 2; // Twos
+			}
+			else if (currentBombs < maxBombs) {
+				cell = 3;
+				currentBombs++;
+			}
+			else {
+				cell = 0;
+			}
+		}
+	}
+
+	// Last resort: no solid wall on the ring through the four spawns, which joins them
+	void OpenSpawnRing(std::vector<uint8_t>& cells, int height, int width)
+	{
+		if (height < 3 || width < 3) {
+			return;
+		}
+		for (int row : { 1, height - 2 }) {
+			for (int col = 1; col <= width - 2; ++col) {
+				uint8_t& cell = cells[static_cast<size_t>(row) * width + col];
+				cell = cell == 2 ? 0 : cell;
+			}
+		}
+		for (int col : { 1, width - 2 }) {
+			for (int row = 1; row <= height - 2; ++row) {
+				uint8_t& cell = cells[static_cast<size_t>(row) * width + col];
+				cell = cell == 2 ? 0 : cell;
+			}
+		}
+	}
+}
+
+namespace mapgen {
+	Map Generate(uint32_t seed, int height, int width, int difficulty)
+	{
+		if (height <= 0 || width <= 0) {
+			throw std::invalid_argument("Invalid board size");
+		}
+
+		Map map{ Hash(seed, height, width, difficulty), seed, height, width, difficulty, std::vector<uint8_t>(static_cast<size_t>(height) * width) };
+		std::mt19937 random(seed);
+		SolidWallFixer fixer(height, width, SOLID_BLOCK_SIZE);
+		ReachabilityValidator validator(height, width);
+
+		// Layouts that cut a spawn corner off are drawn again from the same stream, so
+		// the accepted one is still fixed by the inputs
+		for (int attempt = 0; attempt < MAX_GENERATION_ATTEMPTS; ++attempt) {
+			FillCells(map.cells, random, difficulty);
+			for (auto [x, y] : fixer.Fix(map.cells)) {
+				map.cells[static_cast<size_t>(x) * width + y] = 0;
+			}
+			if (validator.SpawnsConnected(map.cells)) {
+				return map;
+			}
+		}
+
+		OpenSpawnRing(map.cells, height, width);
+		return map;
+	}
+
+	// FNV-1a over the generator inputs
+	uint64_t Hash(uint32_t seed, int height, int width, int difficulty)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (uint64_t value : { uint64_t{ GENERATOR_VERSION }, uint64_t{ seed }, static_cast<uint64_t>(height),
+			static_cast<uint64_t>(width), static_cast<uint64_t>(difficulty) }) {
+			for (int byte = 0; byte < 8; ++byte) {
+				hash ^= (value >> (byte * 8)) & 0xFF;
+				hash *= 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+	// Sixteen lowercase hex digits, as used in /map/<hash> and cache file names
+	std::string FormatHash(uint64_t hash)
+	{
+		const char* digits = "0123456789abcdef";
+		std::string text(16, '0');
+		for (int digit = 15; digit >= 0; --digit, hash >>= 4) {
+			text[digit] = digits[hash & 0xF];
+		}
+		return text;
+	}
+
+	//helper function to modify how the board will be generated based off the selected difficulty
+	void SetPercentages(int difficulty, int& zeroPercent, int& onePercent, int& twoPercent, int& bombPercent)
+	{
+		switch (difficulty) {
+		case 1: // easy
+			zeroPercent = 60;
+			onePercent = 20;
+			twoPercent = 15;
+			bombPercent = 5;
+			break;
+		case 2: // normal
+			zeroPercent = 55;
+			onePercent = 20;
+			twoPercent = 25;
+			bombPercent = 10;
+			break;
+		case 3: // hard
+			zeroPercent = 50;
+			onePercent = 25;
+			twoPercent = 15;
+			bombPercent = 10;
+			break;
+		case 4: //very hard
+			zeroPercent = 40;
+			onePercent = 30;
+			twoPercent = 20;
+			bombPercent = 10;
+			break;
+		default:
+			throw std::runtime_error("Error: Difficulty not set correctly!");
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Board generation as a pure function: the same seed, size and difficulty always
+// give the same cells, whichever thread or board asks. Boards load the result
+// with Board::LoadMap, so maps can be generated ahead of time and off the room's
+// state lock. Since the inputs fix the content, a hash of them (and of the generator
+// version) names a map everywhere: in the cache, on disk and for clients. Layouts in
+// which the four spawn corners cannot reach each other are rejected and drawn again.
+namespace mapgen {
+    const uint32_t GENERATOR_VERSION = 2; // bump whenever the same inputs would give different cells
+
+    struct Map {
+        uint64_t hash = 0;
+        uint32_t seed = 0;
+        int height = 0;
+        int width = 0;
+        int difficulty = 1;
+        std::vector<uint8_t> cells; // row-major cell codes, as in Board
+    };
+
+    Map Generate(uint32_t seed, int height, int width, int difficulty);
+    uint64_t Hash(uint32_t seed, int height, int width, int difficulty);
+    std::string FormatHash(uint64_t hash);
+    void SetPercentages(int difficulty, int& zeroPercent, int& onePercent, int& twoPercent, int& bombPercent);
+}
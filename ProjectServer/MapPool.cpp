@@ -0,0 +1,193 @@
+#include "MapPool.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+	// Same range as mapgen::SetPercentages; checked up front so a worker never sees a bad key
+	void ValidateKey(int height, int width, int difficulty)
+	{
+		if (height <= 0 || width <= 0) {
+			throw std::invalid_argument("Invalid board size");
+		}
+		if (difficulty < 1 || difficulty > 4) {
+			throw std::invalid_argument("Invalid difficulty level");
+		}
+	}
+}
+
+MapPool::MapPool(size_t bucketCapacity, size_t workerCount)
+	: m_seeds(std::random_device{}()),
+	m_bucketCapacity(bucketCapacity),
+	m_hits(0),
+	m_misses(0),
+	m_refilled(0),
+	m_lastRefillTime(0),
+	m_maxRefillTime(0),
+	m_totalRefillTime(0)
+{
+	if (bucketCapacity == 0 || workerCount == 0) {
+		throw std::invalid_argument("Map pool needs a positive bucket capacity and worker count");
+	}
+
+	m_workers.reserve(workerCount);
+	for (size_t worker = 0; worker < workerCount; ++worker) {
+		m_workers.emplace_back([this](std::stop_token stopToken) {
+			RunWorker(stopToken);
+			});
+	}
+}
+
+MapPool::~MapPool()
+{
+	for (std::jthread& worker : m_workers) {
+		worker.request_stop(); // wakes the condition variable wait as well
+	}
+}
+
+// Creates the bucket and fills it in the background, so the first Take is already a hit
+void MapPool::Warm(int height, int width, int difficulty)
+{
+	ValidateKey(height, width, difficulty);
+
+	Key key{ difficulty, height, width };
+	std::lock_guard<std::mutex> lock(m_mutex);
+	ScheduleRefills(key, m_buckets[key]);
+}
+
+// A pooled map when one is ready, otherwise one generated right here. Hits and misses
+// only count the warmed sizes; other sizes are not pooled at all.
+mapgen::Map MapPool::Take(int height, int width, int difficulty)
+{
+	ValidateKey(height, width, difficulty);
+
+	Key key{ difficulty, height, width };
+	uint32_t seed;
+	bool pooled;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Bucket* bucket = FindBucket(key);
+		if (bucket && !bucket->ready.empty()) {
+			mapgen::Map map = std::move(bucket->ready.front());
+			bucket->ready.pop_front();
+			ScheduleRefills(key, *bucket);
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+			return map;
+		}
+
+		pooled = bucket != nullptr;
+		if (pooled) {
+			ScheduleRefills(key, *bucket);
+		}
+		seed = m_seeds();
+	}
+
+	if (pooled) {
+		m_misses.fetch_add(1, std::memory_order_relaxed);
+	}
+	return mapgen::Generate(seed, height, width, difficulty);
+}
+
+size_t MapPool::GetBucketCapacity() const
+{
+	return m_bucketCapacity;
+}
+
+uint64_t MapPool::GetHitCount() const
+{
+	return m_hits.load(std::memory_order_relaxed);
+}
+
+uint64_t MapPool::GetMissCount() const
+{
+	return m_misses.load(std::memory_order_relaxed);
+}
+
+double MapPool::GetHitRate() const
+{
+	uint64_t hits = GetHitCount();
+	uint64_t total = hits + GetMissCount();
+	return total ? static_cast<double>(hits) / total : 0.0;
+}
+
+uint64_t MapPool::GetRefillCount() const
+{
+	return m_refilled.load(std::memory_order_relaxed);
+}
+
+int64_t MapPool::GetLastRefillTime() const
+{
+	return m_lastRefillTime.load(std::memory_order_relaxed);
+}
+
+int64_t MapPool::GetMeanRefillTime() const
+{
+	uint64_t refilled = GetRefillCount();
+	return refilled ? m_totalRefillTime.load(std::memory_order_relaxed) / static_cast<int64_t>(refilled) : 0;
+}
+
+int64_t MapPool::GetMaxRefillTime() const
+{
+	return m_maxRefillTime.load(std::memory_order_relaxed);
+}
+
+std::vector<MapPool::BucketStats> MapPool::GetBuckets() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<BucketStats> buckets;
+	buckets.reserve(m_buckets.size());
+	for (const auto& [key, bucket] : m_buckets) {
+		buckets.push_back(BucketStats{ key.difficulty, key.height, key.width, bucket.ready.size(), bucket.pending });
+	}
+	return buckets;
+}
+
+// Null for sizes that were never warmed; such keys are always generated on demand. The caller holds the lock.
+MapPool::Bucket* MapPool::FindBucket(const Key& key)
+{
+	auto it = m_buckets.find(key);
+	return it != m_buckets.end() ? &it->second : nullptr;
+}
+
+// Queues one refill per map the bucket is short of, counting the ones already on their way. The caller holds the lock.
+void MapPool::ScheduleRefills(const Key& key, Bucket& bucket)
+{
+	size_t missing = m_bucketCapacity - std::min(m_bucketCapacity, bucket.ready.size() + bucket.pending);
+	for (size_t refill = 0; refill < missing; ++refill) {
+		m_refills.push_back(key);
+	}
+	bucket.pending += missing;
+	if (missing == 1) {
+		m_refillNeeded.notify_one();
+	}
+	else if (missing > 1) {
+		m_refillNeeded.notify_all();
+	}
+}
+
+void MapPool::RunWorker(std::stop_token stopToken)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_refillNeeded.wait(lock, stopToken, [this]() { return !m_refills.empty(); })) {
+		Key key = m_refills.front();
+		m_refills.pop_front();
+		uint32_t seed = m_seeds();
+
+		lock.unlock();
+		auto start = std::chrono::steady_clock::now();
+		mapgen::Map map = mapgen::Generate(seed, key.height, key.width, key.difficulty);
+		int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		lock.lock();
+
+		Bucket& bucket = m_buckets[key];
+		--bucket.pending;
+		bucket.ready.push_back(std::move(map));
+
+		m_lastRefillTime.store(elapsed, std::memory_order_relaxed);
+		if (elapsed > m_maxRefillTime.load(std::memory_order_relaxed)) {
+			m_maxRefillTime.store(elapsed, std::memory_order_relaxed);
+		}
+		m_totalRefillTime.fetch_add(elapsed, std::memory_order_relaxed);
+		m_refilled.fetch_add(1, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <compare>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "MapGenerator.h"
+
+// Ready-made maps per (difficulty, height, width) bucket, kept topped up by background
+// workers so creating a room or changing difficulty only has to copy cells in. Only the
+// sizes the server warms at startup get a bucket; asking an empty one is a miss, which
+// generates on the caller's thread and schedules the refill. Any other size is generated
+// on the caller's thread and never pooled, so a client asking for odd or huge boards
+// cannot make the pool hold maps nobody else uses. Every bucket holds at most the
+// bucket capacity, so memory stays bounded by the warmed sizes.
+class MapPool
+{
+public:
+    struct BucketStats {
+        int difficulty;
+        int height;
+        int width;
+        size_t ready;
+        size_t pending; // queued or being generated
+    };
+
+private:
+    struct Key {
+        int difficulty;
+        int height;
+        int width;
+
+        auto operator<=>(const Key&) const = default;
+    };
+
+    struct Bucket {
+        std::deque<mapgen::Map> ready;
+        size_t pending = 0;
+    };
+
+    // Member Variables
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_refillNeeded;
+    std::map<Key, Bucket> m_buckets;
+    std::deque<Key> m_refills; // one entry per map a bucket is missing
+    std::mt19937 m_seeds;
+    size_t m_bucketCapacity;
+    std::atomic<uint64_t> m_hits;
+    std::atomic<uint64_t> m_misses;
+    std::atomic<uint64_t> m_refilled;
+    std::atomic<int64_t> m_lastRefillTime;  // microseconds
+    std::atomic<int64_t> m_maxRefillTime;   // microseconds
+    std::atomic<int64_t> m_totalRefillTime; // microseconds
+    std::vector<std::jthread> m_workers; // declared last so they stop before the buckets are destroyed
+
+public:
+    // Constructor and Destructor
+    MapPool(size_t bucketCapacity, size_t workerCount);
+    ~MapPool();
+
+    // Maps
+    void Warm(int height, int width, int difficulty);
+    mapgen::Map Take(int height, int width, int difficulty);
+
+    // Getters
+    size_t GetBucketCapacity() const;
+    uint64_t GetHitCount() const;
+    uint64_t GetMissCount() const;
+    double GetHitRate() const;
+    uint64_t GetRefillCount() const;
+    int64_t GetLastRefillTime() const; // microseconds
+    int64_t GetMeanRefillTime() const; // microseconds
+    int64_t GetMaxRefillTime() const;  // microseconds
+    std::vector<BucketStats> GetBuckets() const;
+
+private:
+    // Helper Functions
+    Bucket* FindBucket(const Key& key);
+    void ScheduleRefills(const Key& key, Bucket& bucket);
+    void RunWorker(std::stop_token stopToken);
+};
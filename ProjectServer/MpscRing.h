@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+// Bounded lock-free multi-producer, single-consumer ring (Vyukov). Every slot carries
+// a sequence number that tells producers whether it is free and the consumer whether
+// it has been published, so neither side ever takes a lock. A push into a full ring
+// fails instead of waiting.
+template <typename T>
+class MpscRing
+{
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+    // Member Variables
+    std::unique_ptr<Slot[]> m_slots;
+    uint64_t m_mask;
+    alignas(64) std::atomic<uint64_t> m_enqueuePosition;
+    alignas(64) std::atomic<uint64_t> m_dequeuePosition; // only written by the consumer
+
+public:
+    // Constructor and Destructor
+    explicit MpscRing(size_t capacity)
+        : m_mask(0),
+        m_enqueuePosition(0),
+        m_dequeuePosition(0)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("Ring capacity must be positive");
+        }
+
+        // Rounded up to a power of two so a position maps to a slot with a mask
+        capacity = std::bit_ceil(capacity);
+        m_mask = capacity - 1;
+        m_slots = std::make_unique<Slot[]>(capacity);
+        for (size_t slot = 0; slot < capacity; ++slot) {
+            m_slots[slot].sequence.store(slot, std::memory_order_relaxed);
+        }
+    }
+    ~MpscRing() = default;
+
+    // Producers: fill(T&) writes the claimed slot in place; returns false when the ring is full
+    template <typename Fill>
+    bool TryPush(Fill&& fill)
+    {
+        uint64_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &m_slots[position & m_mask];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+            if (difference == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (difference < 0) {
+                return false;
+            }
+            else {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(slot->value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: moves the oldest published value out; returns false when there is none
+    bool TryPop(T& value)
+    {
+        uint64_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[position & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+
+        value = std::move(slot.value);
+        slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+        m_dequeuePosition.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Getters
+    size_t GetCapacity() const
+    {
+        return static_cast<size_t>(m_mask + 1);
+    }
+
+    // Claimed but not yet consumed; approximate while producers are running
+    size_t GetDepth() const
+    {
+        uint64_t dequeued = m_dequeuePosition.load(std::memory_order_relaxed);
+        uint64_t enqueued = m_enqueuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? static_cast<size_t>(enqueued - dequeued) : 0;
+    }
+};
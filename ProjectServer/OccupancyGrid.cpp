@@ -0,0 +1,117 @@
+#include "OccupancyGrid.h"
+
+OccupancyGrid::OccupancyGrid(int height, int width)
+	: m_height(height),
+	m_width(width),
+	m_tankHead(static_cast<size_t>(height) * width, -1),
+	m_bulletHead(static_cast<size_t>(height) * width, -1)
+{}
+
+void OccupancyGrid::PlaceTank(int tank, int row, int col)
+{
+	if (tank >= static_cast<int>(m_tankCell.size())) {
+		m_tankCell.resize(tank + 1, -1);
+		m_nextTank.resize(tank + 1, -1);
+	}
+
+	RemoveTank(tank);
+	if (!IsInside(row, col)) {
+		return;
+	}
+
+	int cell = CellIndex(row, col);
+	m_nextTank[tank] = m_tankHead[cell];
+	m_tankHead[cell] = tank;
+	m_tankCell[tank] = cell;
+}
+
+void OccupancyGrid::RemoveTank(int tank)
+{
+	if (tank >= static_cast<int>(m_tankCell.size()) || m_tankCell[tank] == -1) {
+		return;
+	}
+
+	int32_t* link = &m_tankHead[m_tankCell[tank]];
+	while (*link != -1 && *link != tank) {
+		link = &m_nextTank[*link];
+	}
+	if (*link == tank) {
+		*link = m_nextTank[tank];
+	}
+
+	m_nextTank[tank] = -1;
+	m_tankCell[tank] = -1;
+}
+
+int OccupancyGrid::GetTankAt(int row, int col) const
+{
+	if (!IsInside(row, col)) {
+		return -1;
+	}
+	return m_tankHead[CellIndex(row, col)];
+}
+
+int OccupancyGrid::GetNextTank(int tank) const
+{
+	return m_nextTank[tank];
+}
+
+// Only the cells touched by the previous rebuild are cleared, so the cost follows the bullet count, not the map size
+void OccupancyGrid::RebuildBullets(const BulletPool& bullets)
+{
+	for (int32_t cell : m_bulletCells) {
+		m_bulletHead[cell] = -1;
+	}
+	m_bulletCells.clear();
+	m_nextBullet.assign(bullets.Size(), -1);
+
+	for (size_t bullet = 0; bullet < bullets.Size(); ++bullet) {
+		int row, col;
+		if (!bullets.IsActive(bullet) || !BulletCell(bullets, bullet, row, col) || !IsInside(row, col)) {
+			continue;
+		}
+
+		int cell = CellIndex(row, col);
+		if (m_bulletHead[cell] == -1) {
+			m_bulletCells.push_back(cell);
+		}
+		m_nextBullet[bullet] = m_bulletHead[cell];
+		m_bulletHead[cell] = static_cast<int32_t>(bullet);
+	}
+}
+
+int OccupancyGrid::GetBulletAt(int row, int col) const
+{
+	if (!IsInside(row, col)) {
+		return -1;
+	}
+	return m_bulletHead[CellIndex(row, col)];
+}
+
+int OccupancyGrid::GetNextBullet(int bullet) const
+{
+	return m_nextBullet[bullet];
+}
+
+bool OccupancyGrid::IsInside(int row, int col) const
+{
+	return row >= 0 && row < m_height && col >= 0 && col < m_width;
+}
+
+// Bullets travel in bordered coordinates (x = column + 1, y = row + 1)
+bool OccupancyGrid::BulletCell(const BulletPool& bullets, size_t bullet, int& row, int& col)
+{
+	double y = bullets.GetY(bullet) - 1;
+	double x = bullets.GetX(bullet) - 1;
+	if (y < 0 || x < 0) {
+		return false;
+	}
+	row = static_cast<int>(y);
+	col = static_cast<int>(x);
+	return true;
+}
+
+int OccupancyGrid::CellIndex(int row, int col) const
+{
+	return row * m_width + col;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "BulletPool.h"
+
+// Uniform grid mapping each board cell to the tanks and bullets inside it.
+// Cells hold the head of an intrusive singly linked list so a lookup is O(1)
+// and a cell with several occupants costs only a short walk.
+// Tanks are placed incrementally whenever they move; bullets are rebuilt once per tick.
+class OccupancyGrid {
+private:
+    // Member Variables
+    int m_height;
+    int m_width;
+    std::vector<int32_t> m_tankHead;     // cell -> first tank, -1 when empty
+    std::vector<int32_t> m_nextTank;     // tank -> next tank in the same cell
+    std::vector<int32_t> m_tankCell;     // tank -> cell, -1 when not placed
+    std::vector<int32_t> m_bulletHead;   // cell -> first bullet index, -1 when empty
+    std::vector<int32_t> m_nextBullet;   // bullet index -> next bullet in the same cell
+    std::vector<int32_t> m_bulletCells;  // cells written by the last rebuild
+
+public:
+    // Constructor and Destructor
+    OccupancyGrid(int height, int width);
+    ~OccupancyGrid() = default;
+
+    // Tanks
+    void PlaceTank(int tank, int row, int col);
+    void RemoveTank(int tank);
+    int GetTankAt(int row, int col) const;
+    int GetNextTank(int tank) const;
+
+    // Bullets
+    void RebuildBullets(const BulletPool& bullets);
+    int GetBulletAt(int row, int col) const;
+    int GetNextBullet(int bullet) const;
+
+    // Helpers
+    bool IsInside(int row, int col) const;
+    static bool BulletCell(const BulletPool& bullets, size_t bullet, int& row, int& col);
+
+private:
+    int CellIndex(int row, int col) const;
+};
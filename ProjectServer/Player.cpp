@@ -2,7 +2,7 @@ module Player;
 
 using namespace boardElements;
 
-Player::Player(uint8_t id, std::string name, std::string password, int highScore, uint8_t remainingLives, int score)
+Player::Player(int id, std::string name, std::string password, int highScore, uint8_t remainingLives, int score)
 	:
 	m_id{ id },
 	m_name{ name },
@@ -20,7 +20,7 @@ void Player::SetScore(const int& score) {
 	m_score = score;
 }
 
-uint8_t Player::GetId() const {
+int Player::GetId() const {
 	return m_id;
 }
 
@@ -32,11 +32,11 @@ int Player::GetHighScore() const {
 	return m_highScore;
 }
 
-std::string Player::GetName() const {
+const std::string& Player::GetName() const {
 	return m_name;
 }
 
-std::string Player::GetPassword() const {
+const std::string& Player::GetPassword() const {
 	return m_password;
 }
 
@@ -10,7 +10,7 @@ namespace boardElements {
     {
     public:
         // Member Variables
-        uint8_t m_id;
+        int m_id;
         int m_highScore;
         int m_score;
         std::string m_name;
@@ -19,17 +19,17 @@ namespace boardElements {
 
     public:
         // Constructors and Destructor
-        Player(uint8_t id, std::string name, std::string password, int highScore, uint8_t remainingLives, int score);
+        Player(int id, std::string name, std::string password, int highScore, uint8_t remainingLives, int score);
         Player() = default;
         ~Player() = default;
 
         // Getters
         int GetScore() const;
-        uint8_t GetId() const;
+        int GetId() const;
         uint8_t GetRemainingLives() const;
         int GetHighScore() const;
-        std::string GetName() const;
-        std::string GetPassword() const;
+        const std::string& GetName() const;
+        const std::string& GetPassword() const;
 
         // Setters
         void SetScore(const int& score);
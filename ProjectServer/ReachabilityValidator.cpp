@@ -0,0 +1,172 @@
+#include "ReachabilityValidator.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+	// One bit per byte of the 8 cells: set unless the cell is a solid wall (code 2)
+	uint64_t OpenBits8(const uint8_t* cells)
+	{
+		uint64_t bytes;
+		std::memcpy(&bytes, cells, sizeof(bytes));
+		bytes ^= 0x0202020202020202ull;
+		// High bit of every byte that is non-zero, i.e. was not 2
+		uint64_t nonZero = (((bytes & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | bytes) & 0x8080808080808080ull;
+		return (nonZero * 0x0002040810204081ull) >> 56;
+	}
+
+	// Bits of open reachable from seed by moving toward higher bits inside one word
+	uint64_t FillUp(uint64_t seed, uint64_t open)
+	{
+		seed &= open;
+		seed |= open & (seed << 1);
+		open &= open << 1;
+		seed |= open & (seed << 2);
+		open &= open << 2;
+		seed |= open & (seed << 4);
+		open &= open << 4;
+		seed |= open & (seed << 8);
+		open &= open << 8;
+		seed |= open & (seed << 16);
+		open &= open << 16;
+		seed |= open & (seed << 32);
+		return seed;
+	}
+
+	// Same toward lower bits
+	uint64_t FillDown(uint64_t seed, uint64_t open)
+	{
+		seed &= open;
+		seed |= open & (seed >> 1);
+		open &= open >> 1;
+		seed |= open & (seed >> 2);
+		open &= open >> 2;
+		seed |= open & (seed >> 4);
+		open &= open >> 4;
+		seed |= open & (seed >> 8);
+		open &= open >> 8;
+		seed |= open & (seed >> 16);
+		open &= open >> 16;
+		seed |= open & (seed >> 32);
+		return seed;
+	}
+}
+
+ReachabilityValidator::ReachabilityValidator(int height, int width)
+	: m_height(height),
+	m_width(width),
+	m_stride((static_cast<size_t>(std::max(width, 0)) + 63) / 64)
+{
+	if (height <= 0 || width <= 0) {
+		throw std::invalid_argument("Invalid board size");
+	}
+	m_open.resize(m_stride * height);
+	m_reached.resize(m_stride * height);
+}
+
+// Boards too small to have four distinct spawn areas are accepted as they are
+bool ReachabilityValidator::SpawnsConnected(std::span<const uint8_t> cells)
+{
+	if (cells.size() != static_cast<size_t>(m_height) * m_width) {
+		throw std::invalid_argument("Cell count does not match the board size");
+	}
+	if (m_height < 3 || m_width < 3) {
+		return true;
+	}
+
+	const int spawns[4][2] = { { 1, 1 }, { 1, m_width - 2 }, { m_height - 2, 1 }, { m_height - 2, m_width - 2 } };
+
+	LoadOpenCells(cells);
+	for (const auto& spawn : spawns) {
+		OpenAround(spawn[0], spawn[1]);
+	}
+
+	std::fill(m_reached.begin(), m_reached.end(), 0);
+	m_reached[static_cast<size_t>(spawns[0][0]) * m_stride + spawns[0][1] / 64] |= uint64_t{ 1 } << (spawns[0][1] % 64);
+
+	auto allReached = [&]() {
+		return std::all_of(std::begin(spawns), std::end(spawns), [&](const auto& spawn) {
+			return IsReached(spawn[0], spawn[1]);
+			});
+		};
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int row = 0; row < m_height; ++row) {
+			changed |= SweepRow(row, row > 0 ? &m_reached[(row - 1) * m_stride] : nullptr);
+		}
+		for (int row = m_height - 1; row >= 0; --row) {
+			changed |= SweepRow(row, row + 1 < m_height ? &m_reached[(row + 1) * m_stride] : nullptr);
+		}
+		if (allReached()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ReachabilityValidator::LoadOpenCells(std::span<const uint8_t> cells)
+{
+	for (int row = 0; row < m_height; ++row) {
+		const uint8_t* cellRow = cells.data() + static_cast<size_t>(row) * m_width;
+		uint64_t* open = &m_open[row * m_stride];
+		for (size_t word = 0; word < m_stride; ++word) {
+			uint64_t bits = 0;
+			int first = static_cast<int>(word * 64);
+			int last = std::min(first + 64, m_width);
+			int col = first;
+			for (; col + 8 <= last; col += 8) {
+				bits |= OpenBits8(cellRow + col) << (col - first);
+			}
+			for (; col < last; ++col) {
+				bits |= cellRow[col] != 2 ? uint64_t{ 1 } << (col - first) : 0;
+			}
+			open[word] = bits;
+		}
+	}
+}
+
+void ReachabilityValidator::OpenAround(int x, int y)
+{
+	for (int row = std::max(x - 1, 0); row <= std::min(x + 1, m_height - 1); ++row) {
+		for (int col = std::max(y - 1, 0); col <= std::min(y + 1, m_width - 1); ++col) {
+			m_open[row * m_stride + col / 64] |= uint64_t{ 1 } << (col % 64);
+		}
+	}
+}
+
+bool ReachabilityValidator::IsReached(int x, int y) const
+{
+	return (m_reached[x * m_stride + y / 64] >> (y % 64)) & 1;
+}
+
+// Pulls in what the neighbouring row reaches, then closes the row horizontally.
+// Returns whether the row gained any cell.
+bool ReachabilityValidator::SweepRow(int row, const uint64_t* neighbour)
+{
+	uint64_t* reached = &m_reached[row * m_stride];
+	const uint64_t* open = &m_open[row * m_stride];
+	bool changed = false;
+
+	uint64_t carry = 0; // whether the top bit of the previous word was reached
+	for (size_t word = 0; word < m_stride; ++word) {
+		uint64_t seed = reached[word] | carry;
+		if (neighbour) {
+			seed |= neighbour[word];
+		}
+		uint64_t filled = FillUp(seed, open[word]);
+		changed |= filled != reached[word];
+		reached[word] = filled;
+		carry = filled >> 63;
+	}
+
+	carry = 0; // whether the bottom bit of the next word was reached
+	for (size_t word = m_stride; word-- > 0;) {
+		uint64_t filled = FillDown(reached[word] | (carry << 63), open[word]);
+		changed |= filled != reached[word];
+		reached[word] = filled;
+		carry = filled & 1;
+	}
+	return changed;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Checks that the four spawn corners used by Board::InsertPlayer ((1, 1), (1, w - 2),
+// (h - 2, 1), (h - 2, w - 2)) can reach each other. Only solid walls block: breakable
+// walls and bombs can be shot away, and the 3 x 3 around every spawn is cleared when a
+// tank is placed there.
+//
+// The flood fill works on one bit per cell. Each row is closed horizontally with a
+// logarithmic fill inside every 64-bit word, carried across word boundaries, and rows
+// are swept top to bottom and back until nothing changes, so a typical map needs a
+// handful of passes over height * width / 64 words.
+class ReachabilityValidator
+{
+private:
+    // Member Variables
+    int m_height;
+    int m_width;
+    size_t m_stride; // words per row
+    std::vector<uint64_t> m_open;    // cells a tank can get through
+    std::vector<uint64_t> m_reached;
+
+public:
+    // Constructor and Destructor
+    ReachabilityValidator(int height, int width);
+    ~ReachabilityValidator() = default;
+
+    // Validation
+    bool SpawnsConnected(std::span<const uint8_t> cells);
+
+private:
+    // Helper Functions
+    void LoadOpenCells(std::span<const uint8_t> cells);
+    void OpenAround(int x, int y);
+    bool IsReached(int x, int y) const;
+    bool SweepRow(int row, const uint64_t* neighbour);
+};
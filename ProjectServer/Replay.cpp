@@ -0,0 +1,128 @@
+#include "Replay.h"
+#include <stdexcept>
+
+namespace {
+	template<typename T>
+	void Put(char*& out, T value)
+	{
+		for (size_t byte = 0; byte < sizeof(T); ++byte) {
+			*out++ = static_cast<char>((static_cast<uint64_t>(value) >> (byte * 8)) & 0xFF);
+		}
+	}
+
+	template<typename T>
+	T Get(const char*& in)
+	{
+		uint64_t value = 0;
+		for (size_t byte = 0; byte < sizeof(T); ++byte) {
+			value |= static_cast<uint64_t>(static_cast<uint8_t>(*in++)) << (byte * 8);
+		}
+		return static_cast<T>(value);
+	}
+}
+
+// Starts a new replay file; events are only ever appended after the header
+ReplayWriter::ReplayWriter(const std::string& path, const replay::Header& header)
+	: m_file(path, std::ios_base::binary | std::ios_base::trunc),
+	m_start(std::chrono::steady_clock::now())
+{
+	if (!m_file.is_open()) {
+		throw std::runtime_error("Failed to open replay file " + path);
+	}
+
+	char buffer[replay::HEADER_SIZE];
+	char* out = buffer;
+	Put(out, replay::MAGIC);
+	Put(out, replay::FORMAT_VERSION);
+	Put(out, header.seed);
+	Put(out, header.height);
+	Put(out, header.width);
+	Put(out, header.difficulty);
+	Put(out, header.ticksPerSecond);
+	m_file.write(buffer, sizeof(buffer));
+}
+
+// Goes to the stream buffer only; the file is written when the buffer fills or on Flush
+void ReplayWriter::Append(uint64_t tick, replay::EventType type, uint8_t player, uint8_t value, uint32_t argument)
+{
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start);
+
+	char buffer[replay::EVENT_SIZE];
+	char* out = buffer;
+	Put(out, tick);
+	Put(out, static_cast<uint32_t>(elapsed.count()));
+	Put(out, static_cast<uint8_t>(type));
+	Put(out, player);
+	Put(out, value);
+	Put(out, uint8_t{ 0 });
+	Put(out, argument);
+	m_file.write(buffer, sizeof(buffer));
+}
+
+void ReplayWriter::Flush(uint64_t tick)
+{
+	Append(tick, replay::EventType::Checkpoint, 0, 0);
+	m_file.flush();
+}
+
+ReplayReader::ReplayReader(const std::string& path)
+	: m_file(path, std::ios_base::binary),
+	m_header{},
+	m_version(replay::FORMAT_VERSION),
+	m_eventSize(replay::EVENT_SIZE)
+{
+	if (!m_file.is_open()) {
+		throw std::runtime_error("Failed to open replay file " + path);
+	}
+
+	char buffer[replay::HEADER_SIZE];
+	if (!m_file.read(buffer, sizeof(buffer))) {
+		throw std::runtime_error("Replay file is too short");
+	}
+
+	const char* in = buffer;
+	if (Get<uint32_t>(in) != replay::MAGIC) {
+		throw std::runtime_error("Not a replay file");
+	}
+	m_version = Get<uint16_t>(in);
+	if (m_version == 1) {
+		m_eventSize = replay::EVENT_SIZE_V1;
+	}
+	else if (m_version != 2 && m_version != replay::FORMAT_VERSION) {
+		throw std::runtime_error("Unsupported replay format version " + std::to_string(m_version));
+	}
+	m_header.seed = Get<uint32_t>(in);
+	m_header.height = Get<uint16_t>(in);
+	m_header.width = Get<uint16_t>(in);
+	m_header.difficulty = Get<uint8_t>(in);
+	m_header.ticksPerSecond = Get<uint16_t>(in);
+}
+
+const replay::Header& ReplayReader::GetHeader() const
+{
+	return m_header;
+}
+
+// Returns false at the end of the file; a torn last event (crash mid-write) is ignored
+bool ReplayReader::Next(replay::Event& event)
+{
+	char buffer[replay::EVENT_SIZE];
+	if (!m_file.read(buffer, m_eventSize)) {
+		return false;
+	}
+
+	const char* in = buffer;
+	event.tick = Get<uint64_t>(in);
+	event.milliseconds = Get<uint32_t>(in);
+	event.type = static_cast<replay::EventType>(Get<uint8_t>(in));
+	event.player = Get<uint8_t>(in);
+	event.value = Get<uint8_t>(in);
+	Get<uint8_t>(in); // reserved
+	event.argument = m_eventSize == replay::EVENT_SIZE ? Get<uint32_t>(in) : 0;
+
+	bool playerInput = event.type == replay::EventType::Join || event.type == replay::EventType::Move || event.type == replay::EventType::Shoot;
+	if (m_version < 3 && playerInput) {
+		event.argument = event.player;
+	}
+	return true;
+}
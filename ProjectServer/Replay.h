@@ -0,0 +1,85 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Append-only binary replay of one room: a fixed header with everything needed to
+// rebuild the board (seed, size, difficulty, tick rate) followed by fixed-size input
+// events stamped with the tick they were applied after. All integers are little-endian.
+//
+//   Header  : magic u32, format u16, seed u32, height u16, width u16, difficulty u8, ticksPerSecond u16
+//   Event   : tick u64, milliseconds since recording started u32, type u8, player u8, value u8, reserved u8, argument u32
+//
+// Format 1 events have no argument (16 bytes); they are still read, with the argument as 0.
+// Formats 1 and 2 kept the player id of Join, Move and Shoot in the player byte, truncated
+// to 8 bits; reading them moves it into the argument.
+namespace replay {
+    const uint32_t MAGIC = 0x50524B54; // "TKRP"
+    const uint16_t FORMAT_VERSION = 3;
+    const size_t HEADER_SIZE = 17;
+    const size_t EVENT_SIZE = 20;
+    const size_t EVENT_SIZE_V1 = 16;
+
+    enum class EventType : uint8_t {
+        Generate = 1,   // value = difficulty
+        Join = 2,       // argument = player id, value = remaining lives
+        Move = 3,       // argument = player id, value = key
+        Shoot = 4,      // argument = player id
+        Checkpoint = 5, // marks how far the simulation had run when the file was flushed
+        LoadMap = 6     // value = difficulty, argument = map seed (see mapgen::Generate)
+    };
+
+    struct Header {
+        uint32_t seed;
+        uint16_t height;
+        uint16_t width;
+        uint8_t difficulty;
+        uint16_t ticksPerSecond;
+    };
+
+    struct Event {
+        uint64_t tick;
+        uint32_t milliseconds;
+        EventType type;
+        uint8_t player; // unused since format 3; player ids travel in the argument
+        uint8_t value;
+        uint32_t argument;
+    };
+}
+
+class ReplayWriter
+{
+private:
+    // Member Variables
+    std::ofstream m_file;
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    // Constructor and Destructor
+    ReplayWriter(const std::string& path, const replay::Header& header);
+    ~ReplayWriter() = default;
+
+    // Recording
+    void Append(uint64_t tick, replay::EventType type, uint8_t player, uint8_t value, uint32_t argument = 0);
+    void Flush(uint64_t tick);
+};
+
+class ReplayReader
+{
+private:
+    // Member Variables
+    std::ifstream m_file;
+    replay::Header m_header;
+    uint16_t m_version;
+    size_t m_eventSize; // depends on the format version of the file
+
+public:
+    // Constructor and Destructor
+    explicit ReplayReader(const std::string& path);
+    ~ReplayReader() = default;
+
+    // Reading
+    const replay::Header& GetHeader() const;
+    bool Next(replay::Event& event);
+};
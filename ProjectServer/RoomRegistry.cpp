@@ -0,0 +1,173 @@
+#include "RoomRegistry.h"
+#include <filesystem>
+
+RoomRegistry::RoomRegistry(int ticksPerSecond, size_t maxRooms)
+	: m_nextRoomId(1),
+	m_ticksPerSecond(ticksPerSecond),
+	m_maxRooms(maxRooms),
+	m_mapPool(nullptr),
+	m_mapCache(nullptr),
+	m_tickHistogram(nullptr),
+	m_lockWaitHistogram(nullptr)
+{}
+
+// Generates and starts a new room, returns its id. A map seed gives the same walls every
+// time (rematches, tournaments); without one the room gets a fresh map.
+int RoomRegistry::CreateRoom(int height, int width, int difficulty, std::optional<uint32_t> mapSeed)
+{
+	auto room = std::make_shared<Board>(height, width, difficulty);
+
+	int roomId;
+	{
+		std::unique_lock<std::shared_mutex> lock(m_roomsMutex);
+		if (m_rooms.size() >= m_maxRooms) {
+			throw std::runtime_error("Room limit reached");
+		}
+		roomId = m_nextRoomId++;
+		m_rooms.emplace(roomId, nullptr); // reserve the id while the board is generated
+	}
+
+	try {
+		StartRoom(roomId, *room, mapSeed);
+	}
+	catch (...) {
+		std::unique_lock<std::shared_mutex> lock(m_roomsMutex);
+		m_rooms.erase(roomId);
+		throw;
+	}
+
+	std::unique_lock<std::shared_mutex> lock(m_roomsMutex);
+	m_rooms[roomId] = std::move(room);
+	return roomId;
+}
+
+void RoomRegistry::AddRoom(int roomId, std::shared_ptr<Board> room)
+{
+	StartRoom(roomId, *room, std::nullopt);
+
+	std::unique_lock<std::shared_mutex> lock(m_roomsMutex);
+	if (!m_rooms.emplace(roomId, std::move(room)).second) {
+		throw std::invalid_argument("Room already exists");
+	}
+	if (roomId >= m_nextRoomId) {
+		m_nextRoomId = roomId + 1;
+	}
+}
+
+// Rooms added from now on write a replay file into directory; set it before adding rooms
+void RoomRegistry::SetReplayDirectory(const std::string& directory)
+{
+	std::filesystem::create_directories(directory);
+	m_replayDirectory = directory;
+}
+
+// Rooms added from now on without a map seed start on a pooled map instead of generating one
+void RoomRegistry::SetMapPool(MapPool* mapPool)
+{
+	m_mapPool = mapPool;
+}
+
+// Rooms started from now on load seeded maps through the cache and leave their maps in it for /map/<hash>
+void RoomRegistry::SetMapCache(MapCache* mapCache)
+{
+	m_mapCache = mapCache;
+}
+
+// Rooms started from now on record their tick durations and state lock waits into these, shared by all of them
+void RoomRegistry::SetHistograms(LatencyHistogram* tickDuration, LatencyHistogram* stateLockWait)
+{
+	m_tickHistogram = tickDuration;
+	m_lockWaitHistogram = stateLockWait;
+}
+
+void RoomRegistry::StartRoom(int roomId, Board& room, std::optional<uint32_t> mapSeed)
+{
+	if (!m_replayDirectory.empty()) {
+		std::string name = "room-" + std::to_string(roomId) + "-" + std::to_string(room.GetSeed()) + ".replay";
+		room.StartRecording((std::filesystem::path(m_replayDirectory) / name).string(), m_ticksPerSecond);
+	}
+	if (std::shared_ptr<const mapgen::Map> map = TakeMap(room, mapSeed)) {
+		room.LoadMap(*map);
+	}
+	else {
+		room.GenerateBoard();
+	}
+	room.SetHistograms(m_tickHistogram, m_lockWaitHistogram);
+	room.SetTraceName("room " + std::to_string(roomId));
+	room.StartSimulation(m_ticksPerSecond);
+}
+
+// Null when the room should generate its own map
+std::shared_ptr<const mapgen::Map> RoomRegistry::TakeMap(const Board& room, std::optional<uint32_t> mapSeed)
+{
+	int height = room.GetHeight();
+	int width = room.GetWidth();
+	int difficulty = room.GetDifficulty();
+
+	if (mapSeed) {
+		if (m_mapCache) {
+			return m_mapCache->Get(*mapSeed, height, width, difficulty);
+		}
+		return std::make_shared<const mapgen::Map>(mapgen::Generate(*mapSeed, height, width, difficulty));
+	}
+
+	if (m_mapPool) {
+		mapgen::Map map = m_mapPool->Take(height, width, difficulty);
+		if (m_mapCache) {
+			return m_mapCache->Insert(std::move(map));
+		}
+		return std::make_shared<const mapgen::Map>(std::move(map));
+	}
+	return nullptr;
+}
+
+// The board is torn down once the last request still using it lets go
+bool RoomRegistry::RemoveRoom(int roomId)
+{
+	std::shared_ptr<Board> removed;
+	{
+		std::unique_lock<std::shared_mutex> lock(m_roomsMutex);
+		auto it = m_rooms.find(roomId);
+		if (it == m_rooms.end() || !it->second) {
+			return false;
+		}
+		removed = std::move(it->second);
+		m_rooms.erase(it);
+	}
+	return true;
+}
+
+std::shared_ptr<Board> RoomRegistry::GetRoom(int roomId) const
+{
+	std::shared_lock<std::shared_mutex> lock(m_roomsMutex);
+	auto it = m_rooms.find(roomId);
+	if (it == m_rooms.end()) {
+		return nullptr;
+	}
+	return it->second;
+}
+
+std::vector<int> RoomRegistry::GetRoomIds() const
+{
+	std::shared_lock<std::shared_mutex> lock(m_roomsMutex);
+	std::vector<int> roomIds;
+	roomIds.reserve(m_rooms.size());
+	for (const auto& [roomId, room] : m_rooms) {
+		if (room) {
+			roomIds.push_back(roomId);
+		}
+	}
+	std::sort(roomIds.begin(), roomIds.end());
+	return roomIds;
+}
+
+size_t RoomRegistry::GetRoomCount() const
+{
+	std::shared_lock<std::shared_mutex> lock(m_roomsMutex);
+	return m_rooms.size();
+}
+
+size_t RoomRegistry::GetMaxRooms() const
+{
+	return m_maxRooms;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <shared_mutex>
+#include <vector>
+#include <string>
+#include "Board.h"
+#include "MapPool.h"
+#include "MapCache.h"
+
+// Owns every running match. Each room is an independent Board with its own
+// simulation thread and state lock, so rooms never wait on each other; the
+// registry lock is only held to look a room up, add it or remove it.
+//
+// The map pool, map cache and histograms passed to the setters are borrowed, not
+// owned, and must outlive the registry. Rooms keep recording into the histograms,
+// so those must also outlive every room it started, including one a request still
+// holds after RemoveRoom; main declares all of them before the registry.
+class RoomRegistry
+{
+private:
+    // Member Variables
+    mutable std::shared_mutex m_roomsMutex;
+    std::unordered_map<int, std::shared_ptr<Board>> m_rooms;
+    int m_nextRoomId;
+    int m_ticksPerSecond;
+    size_t m_maxRooms;
+    std::string m_replayDirectory; // empty when rooms are not recorded
+    MapPool* m_mapPool;            // null when every room generates its own map
+    MapCache* m_mapCache;          // null when maps are not kept for /map/<hash>
+    LatencyHistogram* m_tickHistogram;     // null when rooms are not monitored
+    LatencyHistogram* m_lockWaitHistogram;
+
+public:
+    // Constructor and Destructor
+    RoomRegistry(int ticksPerSecond, size_t maxRooms);
+    ~RoomRegistry() = default;
+
+    // Room Management
+    int CreateRoom(int height, int width, int difficulty, std::optional<uint32_t> mapSeed = std::nullopt);
+    void AddRoom(int roomId, std::shared_ptr<Board> room);
+    bool RemoveRoom(int roomId);
+    void SetReplayDirectory(const std::string& directory);
+    void SetMapPool(MapPool* mapPool);
+    void SetMapCache(MapCache* mapCache);
+    void SetHistograms(LatencyHistogram* tickDuration, LatencyHistogram* stateLockWait);
+
+    // Getters
+    std::shared_ptr<Board> GetRoom(int roomId) const;
+    std::vector<int> GetRoomIds() const;
+    size_t GetRoomCount() const;
+    size_t GetMaxRooms() const;
+
+private:
+    void StartRoom(int roomId, Board& room, std::optional<uint32_t> mapSeed);
+    std::shared_ptr<const mapgen::Map> TakeMap(const Board& room, std::optional<uint32_t> mapSeed);
+};
@@ -0,0 +1,258 @@
+#include "ServerMetrics.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+	// Exported bucket bounds, 10 us to 10 s; the histograms themselves keep 1% resolution
+	const std::array<uint64_t, 19> EXPORT_BOUNDS = {
+		10, 25, 50, 100, 250, 500,
+		1'000, 2'500, 5'000, 10'000, 25'000, 50'000,
+		100'000, 250'000, 500'000, 1'000'000, 2'500'000, 5'000'000, 10'000'000
+	};
+	const char* STATUS_LABELS[] = { "1xx", "2xx", "3xx", "4xx", "5xx" };
+
+	// Exact decimal seconds, without the rounding of a double
+	std::string Seconds(uint64_t micros)
+	{
+		std::string fraction = std::to_string(1'000'000 + micros % 1'000'000).substr(1);
+		fraction.erase(fraction.find_last_not_of('0') + 1);
+		return std::to_string(micros / 1'000'000) + (fraction.empty() ? "" : "." + fraction);
+	}
+
+	std::string EscapeLabel(std::string_view value)
+	{
+		std::string escaped;
+		for (char c : value) {
+			if (c == '\\' || c == '"') {
+				escaped += '\\';
+				escaped += c;
+			}
+			else if (c == '\n') {
+				escaped += "\\n";
+			}
+			else {
+				escaped += c;
+			}
+		}
+		return escaped;
+	}
+
+	void WriteFamily(std::string& out, const char* name, const char* type, const char* help)
+	{
+		out += "# HELP ";
+		out += name;
+		out += ' ';
+		out += help;
+		out += "\n# TYPE ";
+		out += name;
+		out += ' ';
+		out += type;
+		out += '\n';
+	}
+
+	// labels is empty or a list like route="/game", without braces
+	void WriteHistogram(std::string& out, const char* name, const std::string& labels, const LatencyHistogram& histogram)
+	{
+		std::vector<uint64_t> cumulative = histogram.GetCumulativeCounts(EXPORT_BOUNDS);
+		std::string prefix = labels.empty() ? "" : labels + ",";
+		for (size_t bound = 0; bound <= EXPORT_BOUNDS.size(); ++bound) {
+			std::string le = bound < EXPORT_BOUNDS.size() ? Seconds(EXPORT_BOUNDS[bound]) : "+Inf";
+			out += std::string(name) + "_bucket{" + prefix + "le=\"" + le + "\"} " + std::to_string(cumulative[bound]) + "\n";
+		}
+
+		std::string braces = labels.empty() ? "" : "{" + labels + "}";
+		out += std::string(name) + "_sum" + braces + " " + Seconds(histogram.GetSum()) + "\n";
+		out += std::string(name) + "_count" + braces + " " + std::to_string(cumulative.back()) + "\n";
+	}
+
+	bool IsNumber(std::string_view segment)
+	{
+		return !segment.empty() && std::all_of(segment.begin(), segment.end(), [](char c) {
+			return c >= '0' && c <= '9';
+			});
+	}
+}
+
+ServerMetrics::RouteMetrics::RouteMetrics(std::string route)
+	: route(std::move(route))
+{
+}
+
+ServerMetrics::ServerMetrics()
+	: m_otherRoutes("other")
+{
+}
+
+ServerMetrics::~ServerMetrics()
+{
+	for (std::atomic<RouteMetrics*>& slot : m_routes) {
+		delete slot.load();
+	}
+}
+
+// 404s only count under a route that has already answered something else, so scanners
+// probing random paths end up in "other" instead of growing the table
+void ServerMetrics::RecordRequest(std::string_view path, int status, uint64_t micros)
+{
+	RouteMetrics* entry = FindRoute(RouteOf(path), status != 404);
+	if (!entry) {
+		entry = &m_otherRoutes;
+	}
+
+	entry->latency.Record(micros);
+	size_t statusClass = static_cast<size_t>(std::clamp(status / 100, 1, static_cast<int>(STATUS_CLASSES)) - 1);
+	entry->responses[statusClass].fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogram& ServerMetrics::GetTickDuration()
+{
+	return m_tickDuration;
+}
+
+LatencyHistogram& ServerMetrics::GetStateLockWait()
+{
+	return m_stateLockWait;
+}
+
+LatencyHistogram& ServerMetrics::GetDatabaseQueries()
+{
+	return m_databaseQueries;
+}
+
+std::string ServerMetrics::Expose(const RoomRegistry& rooms) const
+{
+	std::vector<const RouteMetrics*> routes;
+	for (const std::atomic<RouteMetrics*>& slot : m_routes) {
+		if (const RouteMetrics* entry = slot.load(std::memory_order_acquire)) {
+			routes.push_back(entry);
+		}
+	}
+	std::sort(routes.begin(), routes.end(), [](const RouteMetrics* a, const RouteMetrics* b) {
+		return a->route < b->route;
+		});
+	routes.push_back(&m_otherRoutes);
+
+	std::string out;
+	WriteFamily(out, "battlecity_http_requests_total", "counter", "Requests answered, by route and status class.");
+	for (const RouteMetrics* entry : routes) {
+		for (size_t statusClass = 0; statusClass < STATUS_CLASSES; ++statusClass) {
+			uint64_t count = entry->responses[statusClass].load(std::memory_order_relaxed);
+			if (count != 0) {
+				out += "battlecity_http_requests_total{route=\"" + EscapeLabel(entry->route) + "\",code=\"" + STATUS_LABELS[statusClass] + "\"} "
+					+ std::to_string(count) + "\n";
+			}
+		}
+	}
+
+	WriteFamily(out, "battlecity_http_request_duration_seconds", "histogram", "Time from a request being parsed to its response being ready.");
+	for (const RouteMetrics* entry : routes) {
+		if (entry->latency.GetCount() != 0) {
+			WriteHistogram(out, "battlecity_http_request_duration_seconds", "route=\"" + EscapeLabel(entry->route) + "\"", entry->latency);
+		}
+	}
+
+	WriteFamily(out, "battlecity_tick_duration_seconds", "histogram", "Simulation ticks of every room, state lock wait included.");
+	WriteHistogram(out, "battlecity_tick_duration_seconds", "", m_tickDuration);
+
+	WriteFamily(out, "battlecity_state_lock_wait_seconds", "histogram", "Waits for a room's state lock by ticks and request handlers; 0 when it was free.");
+	WriteHistogram(out, "battlecity_state_lock_wait_seconds", "", m_stateLockWait);
+
+	WriteFamily(out, "battlecity_sqlite_query_duration_seconds", "histogram", "Player database calls, each timed on its own.");
+	WriteHistogram(out, "battlecity_sqlite_query_duration_seconds", "", m_databaseQueries);
+
+	// Room gauges come from the published snapshots, so a scrape never takes a state lock
+	std::vector<std::pair<int, std::shared_ptr<const BoardSnapshot>>> snapshots;
+	for (int roomId : rooms.GetRoomIds()) {
+		if (std::shared_ptr<Board> room = rooms.GetRoom(roomId)) {
+			snapshots.emplace_back(roomId, room->GetLatestSnapshot());
+		}
+	}
+
+	size_t activeBullets = 0;
+	WriteFamily(out, "battlecity_rooms", "gauge", "Rooms running.");
+	out += "battlecity_rooms " + std::to_string(snapshots.size()) + "\n";
+	WriteFamily(out, "battlecity_room_players", "gauge", "Tanks in each room.");
+	for (const auto& [roomId, snapshot] : snapshots) {
+		out += "battlecity_room_players{room=\"" + std::to_string(roomId) + "\"} " + std::to_string(snapshot->GetTanks().size()) + "\n";
+	}
+	WriteFamily(out, "battlecity_room_bullets", "gauge", "Bullets in flight in each room.");
+	for (const auto& [roomId, snapshot] : snapshots) {
+		activeBullets += snapshot->GetBullets().size();
+		out += "battlecity_room_bullets{room=\"" + std::to_string(roomId) + "\"} " + std::to_string(snapshot->GetBullets().size()) + "\n";
+	}
+	WriteFamily(out, "battlecity_active_bullets", "gauge", "Bullets in flight over all rooms.");
+	out += "battlecity_active_bullets " + std::to_string(activeBullets) + "\n";
+	return out;
+}
+
+// Crow does not tell middleware which rule matched, so the parameters in the path are folded
+// back into the rule: /room/3/action/7/w -> /room/<int>/action/<int>/<string>
+std::string ServerMetrics::RouteOf(std::string_view path)
+{
+	path = path.substr(0, path.find('?'));
+
+	std::string route;
+	std::string_view previous;
+	std::string_view beforePrevious;
+	size_t start = path.starts_with('/') ? 1 : 0;
+	while (start <= path.size()) {
+		size_t end = std::min(path.find('/', start), path.size());
+		std::string_view segment = path.substr(start, end - start);
+
+		route += '/';
+		if (previous == "map" || beforePrevious == "action") {
+			route += "<string>";
+		}
+		else if (IsNumber(segment)) {
+			route += "<int>";
+		}
+		else {
+			route += segment;
+		}
+
+		beforePrevious = previous;
+		previous = segment;
+		start = end + 1;
+	}
+	return route;
+}
+
+// Lock-free lookup in an insert-only table: a new route is claimed with one compare-exchange
+// and entries are never moved or freed while the server runs
+ServerMetrics::RouteMetrics* ServerMetrics::FindRoute(const std::string& route, bool create)
+{
+	size_t slot = std::hash<std::string>{}(route) % ROUTE_SLOTS;
+	for (size_t probe = 0; probe < ROUTE_SLOTS; ++probe, slot = (slot + 1) % ROUTE_SLOTS) {
+		RouteMetrics* entry = m_routes[slot].load(std::memory_order_acquire);
+		if (!entry) {
+			if (!create) {
+				return nullptr;
+			}
+
+			auto fresh = std::make_unique<RouteMetrics>(route);
+			if (m_routes[slot].compare_exchange_strong(entry, fresh.get(), std::memory_order_acq_rel)) {
+				return fresh.release();
+			}
+			// Another thread claimed the slot first; entry now holds its route
+		}
+		if (entry->route == route) {
+			return entry;
+		}
+	}
+	return nullptr;
+}
+
+void MetricsMiddleware::before_handle(crow::request& req, crow::response& res, context& ctx)
+{
+	ctx.start = std::chrono::steady_clock::now();
+}
+
+void MetricsMiddleware::after_handle(crow::request& req, crow::response& res, context& ctx)
+{
+	if (metrics) {
+		auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - ctx.start);
+		metrics->RecordRequest(req.url, res.code, static_cast<uint64_t>(elapsed.count()));
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <crow.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "LatencyHistogram.h"
+#include "RoomRegistry.h"
+
+// Request latencies and counts per route, tick durations, state lock waits and SQLite
+// query times, served at /metrics in the Prometheus text format together with the
+// players and bullets of every room. Recording is lock-free (relaxed atomic adds into
+// preallocated histograms), so the metrics stay on in production; the cost of walking
+// the histograms is paid by the scrape.
+class ServerMetrics
+{
+public:
+    static constexpr size_t STATUS_CLASSES = 5; // 1xx to 5xx
+
+    struct RouteMetrics {
+        std::string route; // the Crow rule, e.g. /room/<int>/game
+        LatencyHistogram latency;
+        std::array<std::atomic<uint64_t>, STATUS_CLASSES> responses{};
+
+        explicit RouteMetrics(std::string route);
+    };
+
+private:
+    static constexpr size_t ROUTE_SLOTS = 128; // open addressing, never resized; comfortably above the routes in main.cpp
+
+    // Member Variables
+    std::array<std::atomic<RouteMetrics*>, ROUTE_SLOTS> m_routes{};
+    RouteMetrics m_otherRoutes; // paths no route answered, and anything beyond ROUTE_SLOTS
+    LatencyHistogram m_tickDuration;
+    LatencyHistogram m_stateLockWait;
+    LatencyHistogram m_databaseQueries;
+
+public:
+    // Constructor and Destructor
+    ServerMetrics();
+    ~ServerMetrics();
+    ServerMetrics(const ServerMetrics&) = delete;
+    ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+    // Recording
+    void RecordRequest(std::string_view path, int status, uint64_t micros);
+    LatencyHistogram& GetTickDuration();
+    LatencyHistogram& GetStateLockWait();
+    LatencyHistogram& GetDatabaseQueries();
+
+    // Exporting
+    std::string Expose(const RoomRegistry& rooms) const;
+    static std::string RouteOf(std::string_view path);
+
+private:
+    // Helper Functions
+    RouteMetrics* FindRoute(const std::string& route, bool create);
+};
+
+// Crow middleware timing every request from the moment it is parsed until its response is ready
+struct MetricsMiddleware {
+    struct context {
+        std::chrono::steady_clock::time_point start;
+    };
+
+    ServerMetrics* metrics = nullptr; // set before the app runs; nothing is recorded while null
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx);
+    void after_handle(crow::request& req, crow::response& res, context& ctx);
+};
@@ -0,0 +1,49 @@
+#include "SlotTable.h"
+#include <stdexcept>
+
+SlotTable::SlotTable(size_t capacity)
+	: m_capacity(capacity)
+{
+	if (capacity == 0 || capacity > UINT8_MAX) {
+		throw std::invalid_argument("Slot table capacity must be between 1 and 255");
+	}
+	m_slotById.reserve(capacity);
+	m_idBySlot.reserve(capacity);
+}
+
+// Returns the new slot, or nothing when the id already has one or the table is full
+std::optional<uint8_t> SlotTable::Insert(int playerId)
+{
+	if (IsFull() || m_slotById.contains(playerId)) {
+		return std::nullopt;
+	}
+
+	uint8_t slot = static_cast<uint8_t>(m_idBySlot.size());
+	m_slotById.emplace(playerId, slot);
+	m_idBySlot.push_back(playerId);
+	return slot;
+}
+
+std::optional<uint8_t> SlotTable::Find(int playerId) const
+{
+	auto entry = m_slotById.find(playerId);
+	if (entry == m_slotById.end()) {
+		return std::nullopt;
+	}
+	return entry->second;
+}
+
+int SlotTable::GetId(uint8_t slot) const
+{
+	return m_idBySlot.at(slot);
+}
+
+size_t SlotTable::Size() const
+{
+	return m_idBySlot.size();
+}
+
+bool SlotTable::IsFull() const
+{
+	return m_idBySlot.size() >= m_capacity;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// Maps the persistent player ids of a room to the dense slots its per-tank arrays
+// are indexed by. Slots are handed out in join order and are what bullets, the
+// occupancy grid and the wire format refer to a tank by.
+class SlotTable
+{
+private:
+    // Member Variables
+    std::unordered_map<int, uint8_t> m_slotById;
+    std::vector<int> m_idBySlot;
+    size_t m_capacity;
+
+public:
+    // Constructor and Destructor
+    explicit SlotTable(size_t capacity);
+    ~SlotTable() = default;
+
+    // Slot Management
+    std::optional<uint8_t> Insert(int playerId);
+    std::optional<uint8_t> Find(int playerId) const;
+
+    // Getters
+    int GetId(uint8_t slot) const;
+    size_t Size() const;
+    bool IsFull() const;
+};
@@ -0,0 +1,86 @@
+#include "SolidWallFixer.h"
+#include <algorithm>
+#include <stdexcept>
+
+SolidWallFixer::SolidWallFixer(int height, int width, int blockSize)
+	: m_height(height),
+	m_width(width),
+	m_blockSize(blockSize)
+{
+	if (height < 0 || width < 0 || blockSize < 1) {
+		throw std::invalid_argument("Invalid board size or block size");
+	}
+	m_table.resize(static_cast<size_t>(blockSize + 1) * (width + 1));
+	m_columnSolids.resize(width);
+}
+
+const std::vector<std::pair<int, int>>& SolidWallFixer::Fix(std::span<const uint8_t> cells)
+{
+	if (cells.size() != static_cast<size_t>(m_height) * m_width) {
+		throw std::invalid_argument("Cell count does not match the board size");
+	}
+
+	m_cleared.clear();
+	m_solidRows.clear();
+	std::fill(m_columnSolids.begin(), m_columnSolids.end(), 0);
+	std::fill(m_table.begin(), m_table.end(), 0);
+
+	const int k = m_blockSize;
+	const uint32_t fullBlock = static_cast<uint32_t>(k) * k;
+
+	// Table row r + 1 holds the solid walls above and left of row r, with the fixes applied
+	for (int row = 0; row < m_height; ++row) {
+		const uint32_t* above = TableRow(row);
+		uint32_t* current = TableRow(row + 1);
+		const uint32_t* top = row + 1 >= k ? TableRow(row + 1 - k) : nullptr;
+		const uint8_t* cellRow = cells.data() + static_cast<size_t>(row) * m_width;
+		int rowSolids = 0;
+
+		current[0] = 0;
+		for (int col = 0; col < m_width; ++col) {
+			uint32_t solid = cellRow[col] == 2 ? 1 : 0;
+			uint32_t sum = above[col + 1] + current[col] - above[col] + solid;
+
+			// Block whose bottom-right corner is this cell; clearing the corner breaks it
+			if (solid && top && col + 1 >= k) {
+				uint32_t block = sum - top[col + 1] - current[col + 1 - k] + top[col + 1 - k];
+				if (block == fullBlock) {
+					m_cleared.emplace_back(row, col);
+					solid = 0;
+					--sum;
+				}
+			}
+
+			current[col + 1] = sum;
+			rowSolids += solid;
+			m_columnSolids[col] += solid;
+		}
+
+		if (m_width > 0 && rowSolids == m_width) {
+			m_solidRows.push_back(row);
+		}
+	}
+
+	// A solid row loses its left half, which also breaks every column crossing that half
+	for (int row : m_solidRows) {
+		for (int col = 0; col < m_width / 2; ++col) {
+			m_cleared.emplace_back(row, col);
+		}
+	}
+
+	int firstColumn = m_solidRows.empty() ? 0 : m_width / 2;
+	for (int col = firstColumn; col < m_width; ++col) {
+		if (m_height > 0 && m_columnSolids[col] == m_height) {
+			for (int row = 0; row < m_height / 2; ++row) {
+				m_cleared.emplace_back(row, col);
+			}
+		}
+	}
+
+	return m_cleared;
+}
+
+uint32_t* SolidWallFixer::TableRow(int row)
+{
+	return m_table.data() + static_cast<size_t>(row % (m_blockSize + 1)) * (m_width + 1);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Finds the solid walls (type 2) a freshly generated board must not keep: every
+// k x k block made only of solid walls and every row or column that is solid end
+// to end. Block sums come from a summed-area table built in the same row-major pass
+// that fixes them, so a cleared cell is already counted by every later block. Only
+// the last k + 1 rows of the table are kept, so large maps stay cheap.
+class SolidWallFixer
+{
+private:
+    // Member Variables
+    int m_height;
+    int m_width;
+    int m_blockSize;
+    std::vector<uint32_t> m_table;         // k + 1 rolling rows of width + 1 prefix sums
+    std::vector<int> m_columnSolids;       // solid cells per column once blocks are fixed
+    std::vector<int> m_solidRows;
+    std::vector<std::pair<int, int>> m_cleared;
+
+public:
+    // Constructor and Destructor
+    SolidWallFixer(int height, int width, int blockSize);
+    ~SolidWallFixer() = default;
+
+    // Cells (row, column) to clear, blocks first, then rows, then columns
+    const std::vector<std::pair<int, int>>& Fix(std::span<const uint8_t> cells);
+
+private:
+    // Helper Functions
+    uint32_t* TableRow(int row);
+};
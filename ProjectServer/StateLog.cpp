@@ -0,0 +1,49 @@
+#include "StateLog.h"
+
+StateLog::StateLog(size_t capacity)
+	: m_ring(capacity),
+	m_version(0),
+	m_keyframeVersion(0),
+	m_suspended(false)
+{}
+
+void StateLog::Record(ChangeType type, int id, int x, int y, uint8_t value)
+{
+	if (m_suspended) {
+		return;
+	}
+
+	++m_version;
+	m_ring[m_version % m_ring.size()] = StateChange{ m_version, type, value, id, x, y };
+}
+
+// Bulk rewrites (board generation) are not logged cell by cell; readers get a keyframe instead
+void StateLog::BeginKeyframe()
+{
+	m_suspended = true;
+}
+
+void StateLog::EndKeyframe()
+{
+	m_suspended = false;
+	++m_version;
+	m_keyframeVersion = m_version;
+}
+
+uint64_t StateLog::GetVersion() const
+{
+	return m_version;
+}
+
+// Appends every change newer than version; returns false when the caller needs a keyframe
+bool StateLog::CollectSince(uint64_t version, std::vector<StateChange>& changes) const
+{
+	if (version > m_version || version < m_keyframeVersion || m_version - version > m_ring.size()) {
+		return false;
+	}
+
+	for (uint64_t next = version + 1; next <= m_version; ++next) {
+		changes.push_back(m_ring[next % m_ring.size()]);
+	}
+	return true;
+}
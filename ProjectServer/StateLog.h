@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+enum class ChangeType : uint8_t { Cell, Tank, BulletSpawned, BulletDespawned };
+
+// One entry of the change log; the meaning of id and value depends on the type
+struct StateChange {
+    uint64_t version;
+    ChangeType type;
+    uint8_t value;  // cell code for Cell, direction for Tank and BulletSpawned
+    int32_t id;     // player slot or bullet slot
+    int32_t x;
+    int32_t y;
+};
+
+// Bounded log of board changes, each stamped with a monotonically increasing version.
+// Readers ask for everything after the version they already have; once that version
+// has been overwritten (or a keyframe was forced) they must fetch the full state instead.
+class StateLog {
+private:
+    // Member Variables
+    std::vector<StateChange> m_ring;
+    uint64_t m_version;
+    uint64_t m_keyframeVersion; // changes at or before this version are not in the log
+    bool m_suspended;
+
+public:
+    // Constructor
+    explicit StateLog(size_t capacity);
+
+    // Recording
+    void Record(ChangeType type, int id, int x, int y, uint8_t value);
+    void BeginKeyframe();
+    void EndKeyframe();
+
+    // Reading
+    uint64_t GetVersion() const;
+    bool CollectSince(uint64_t version, std::vector<StateChange>& changes) const;
+};
@@ -0,0 +1,66 @@
+#include "SubscriberHub.h"
+#include <algorithm>
+
+// A connection follows a single room; subscribing again moves it
+void SubscriberHub::Subscribe(crow::websocket::connection& connection, int roomId, int playerId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto existing = m_subscriptions.find(&connection);
+	if (existing != m_subscriptions.end()) {
+		std::erase(m_roomSubscribers[existing->second.roomId], &connection);
+	}
+
+	m_subscriptions[&connection] = Subscription{ roomId, playerId };
+	m_roomSubscribers[roomId].push_back(&connection);
+}
+
+void SubscriberHub::Unsubscribe(crow::websocket::connection& connection)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto existing = m_subscriptions.find(&connection);
+	if (existing == m_subscriptions.end()) {
+		return;
+	}
+
+	auto room = m_roomSubscribers.find(existing->second.roomId);
+	std::erase(room->second, &connection);
+	if (room->second.empty()) {
+		m_roomSubscribers.erase(room);
+	}
+	m_subscriptions.erase(existing);
+}
+
+std::optional<SubscriberHub::Subscription> SubscriberHub::GetSubscription(crow::websocket::connection& connection) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto existing = m_subscriptions.find(&connection);
+	if (existing == m_subscriptions.end()) {
+		return std::nullopt;
+	}
+	return existing->second;
+}
+
+size_t SubscriberHub::GetSubscriberCount(int roomId) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto room = m_roomSubscribers.find(roomId);
+	return room == m_roomSubscribers.end() ? 0 : room->second.size();
+}
+
+// send_binary only queues the frame on the connection's io context, so holding the lock here stays cheap
+void SubscriberHub::Broadcast(int roomId, const std::string& frame) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto room = m_roomSubscribers.find(roomId);
+	if (room == m_roomSubscribers.end()) {
+		return;
+	}
+	for (crow::websocket::connection* connection : room->second) {
+		connection->send_binary(frame);
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <crow.h>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Tracks which WebSocket connections follow which room and fans each tick's
+// frame out to them. Connections are owned by Crow; they are removed here from
+// the close handler, which runs before Crow frees them.
+class SubscriberHub
+{
+public:
+    struct Subscription {
+        int roomId;
+        int playerId;
+    };
+
+private:
+    // Member Variables
+    mutable std::mutex m_mutex;
+    std::unordered_map<crow::websocket::connection*, Subscription> m_subscriptions;
+    std::unordered_map<int, std::vector<crow::websocket::connection*>> m_roomSubscribers;
+
+public:
+    // Constructor and Destructor
+    SubscriberHub() = default;
+    ~SubscriberHub() = default;
+
+    // Subscriptions
+    void Subscribe(crow::websocket::connection& connection, int roomId, int playerId);
+    void Unsubscribe(crow::websocket::connection& connection);
+    std::optional<Subscription> GetSubscription(crow::websocket::connection& connection) const;
+    size_t GetSubscriberCount(int roomId) const;
+
+    // Publishing
+    void Broadcast(int roomId, const std::string& frame) const;
+};
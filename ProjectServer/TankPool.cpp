@@ -0,0 +1,125 @@
+#include "TankPool.h"
+#include <stdexcept>
+
+TankPool::TankPool(size_t capacity)
+	: m_capacity(capacity)
+{
+	m_row.reserve(capacity);
+	m_col.reserve(capacity);
+	m_direction.reserve(capacity);
+	m_cooldown.reserve(capacity);
+	m_lives.reserve(capacity);
+	m_alive.reserve(capacity);
+	m_score.reserve(capacity);
+}
+
+// Appends a live tank at the origin and returns its slot; the board places it afterwards
+size_t TankPool::Add(uint8_t lives, int score)
+{
+	if (Size() >= m_capacity) {
+		throw std::length_error("Tank pool is full");
+	}
+
+	m_row.push_back(0);
+	m_col.push_back(0);
+	m_direction.push_back(Direction::UP);
+	m_cooldown.push_back(0.0);
+	m_lives.push_back(lives);
+	m_alive.push_back(true);
+	m_score.push_back(score);
+	return Size() - 1;
+}
+
+size_t TankPool::Size() const
+{
+	return m_row.size();
+}
+
+size_t TankPool::Capacity() const
+{
+	return m_capacity;
+}
+
+int TankPool::GetRow(size_t slot) const
+{
+	return m_row[slot];
+}
+
+int TankPool::GetCol(size_t slot) const
+{
+	return m_col[slot];
+}
+
+Direction TankPool::GetDirection(size_t slot) const
+{
+	return m_direction[slot];
+}
+
+double TankPool::GetCooldown(size_t slot) const
+{
+	return m_cooldown[slot];
+}
+
+bool TankPool::CanShoot(size_t slot) const
+{
+	return m_cooldown[slot] <= 0.0;
+}
+
+uint8_t TankPool::GetLives(size_t slot) const
+{
+	return m_lives[slot];
+}
+
+bool TankPool::IsAlive(size_t slot) const
+{
+	return m_alive[slot];
+}
+
+int TankPool::GetScore(size_t slot) const
+{
+	return m_score[slot];
+}
+
+void TankPool::SetPosition(size_t slot, int row, int col)
+{
+	m_row[slot] = row;
+	m_col[slot] = col;
+}
+
+void TankPool::SetDirection(size_t slot, Direction direction)
+{
+	m_direction[slot] = direction;
+}
+
+void TankPool::SetCooldown(size_t slot, double cooldown)
+{
+	m_cooldown[slot] = cooldown;
+}
+
+void TankPool::SetAlive(size_t slot, bool alive)
+{
+	m_alive[slot] = alive;
+}
+
+// Stops at zero; a tank with no lives left is not respawned
+void TankPool::LoseLife(size_t slot)
+{
+	if (m_lives[slot] > 0) {
+		--m_lives[slot];
+	}
+}
+
+void TankPool::AddScore(size_t slot, int points)
+{
+	m_score[slot] += points;
+}
+
+std::span<double> TankPool::Cooldowns()
+{
+	return m_cooldown;
+}
+
+std::span<const uint8_t> TankPool::Alive() const
+{
+	return m_alive;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+import Direction;
+
+// Simulation state of a room's tanks laid out as struct-of-arrays, one component per
+// array and indexed by slot (see SlotTable). Account data (name, password, high score)
+// stays in the Player objects next to it, so a system walks only the arrays it needs.
+// Tanks are never removed, not even when out of lives, so slots stay dense for the lifetime of the room.
+class TankPool {
+private:
+    // Member Variables (components, indexed by slot)
+    std::vector<int32_t> m_row;
+    std::vector<int32_t> m_col;
+    std::vector<Direction> m_direction;
+    std::vector<double> m_cooldown; // seconds left before the next shot
+    std::vector<uint8_t> m_lives;
+    std::vector<uint8_t> m_alive;
+    std::vector<int32_t> m_score;
+
+    size_t m_capacity;
+
+public:
+    // Constructor and Destructor
+    explicit TankPool(size_t capacity);
+    ~TankPool() = default;
+
+    // Spawning
+    size_t Add(uint8_t lives, int score);
+
+    // Getters (by slot)
+    size_t Size() const;
+    size_t Capacity() const;
+    int GetRow(size_t slot) const;
+    int GetCol(size_t slot) const;
+    Direction GetDirection(size_t slot) const;
+    double GetCooldown(size_t slot) const;
+    bool CanShoot(size_t slot) const;
+    uint8_t GetLives(size_t slot) const;
+    bool IsAlive(size_t slot) const;
+    int GetScore(size_t slot) const;
+
+    // Setters (by slot)
+    void SetPosition(size_t slot, int row, int col);
+    void SetDirection(size_t slot, Direction direction);
+    void SetCooldown(size_t slot, double cooldown);
+    void SetAlive(size_t slot, bool alive);
+    void LoseLife(size_t slot);
+    void AddScore(size_t slot, int points);
+
+    // Whole components, for systems that sweep every tank
+    std::span<double> Cooldowns();
+    std::span<const uint8_t> Alive() const;
+};
@@ -0,0 +1,228 @@
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+	struct Span {
+		const char* name;
+		const char* argName;
+		int64_t start; // nanoseconds on trace::Clock
+		int64_t end;
+		uint64_t arg;
+	};
+
+	// Spans of one thread, written only by that thread. The slots are atomics so an export
+	// copying them while the ring wraps reads old or new values instead of racing; copies
+	// of slots the writer may have reused meanwhile are dropped afterwards.
+	struct SpanRing {
+		struct Slot {
+			std::atomic<const char*> name;
+			std::atomic<const char*> argName;
+			std::atomic<int64_t> start;
+			std::atomic<int64_t> end;
+			std::atomic<uint64_t> arg;
+		};
+
+		int threadId;
+		std::string threadName; // guarded by the registry mutex
+		std::unique_ptr<Slot[]> slots;
+		std::atomic<uint64_t> written;
+
+		SpanRing(int id)
+			: threadId(id),
+			threadName("thread " + std::to_string(id)),
+			slots(std::make_unique<Slot[]>(trace::RING_CAPACITY)),
+			written(0)
+		{
+		}
+
+		void Push(const Span& span)
+		{
+			uint64_t index = written.load(std::memory_order_relaxed);
+			// Keeps the count published by the previous push ahead of these stores, so an
+			// export that reads any of them also sees that the slot is being reused
+			std::atomic_thread_fence(std::memory_order_release);
+
+			Slot& slot = slots[index % trace::RING_CAPACITY];
+			slot.name.store(span.name, std::memory_order_relaxed);
+			slot.argName.store(span.argName, std::memory_order_relaxed);
+			slot.start.store(span.start, std::memory_order_relaxed);
+			slot.end.store(span.end, std::memory_order_relaxed);
+			slot.arg.store(span.arg, std::memory_order_relaxed);
+			written.store(index + 1, std::memory_order_release);
+		}
+
+		// Appends the spans that started at or after since, oldest first
+		void Collect(int64_t since, std::vector<Span>& out) const
+		{
+			uint64_t end = written.load(std::memory_order_acquire);
+			uint64_t begin = end > trace::RING_CAPACITY ? end - trace::RING_CAPACITY : 0;
+
+			std::vector<Span> copied;
+			copied.reserve(static_cast<size_t>(end - begin));
+			for (uint64_t index = begin; index < end; ++index) {
+				const Slot& slot = slots[index % trace::RING_CAPACITY];
+				copied.push_back(Span{ slot.name.load(std::memory_order_relaxed), slot.argName.load(std::memory_order_relaxed),
+					slot.start.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed), slot.arg.load(std::memory_order_relaxed) });
+			}
+
+			// Once the count reaches index + RING_CAPACITY the writer may be overwriting that slot
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t after = written.load(std::memory_order_relaxed);
+			uint64_t firstIntact = after >= trace::RING_CAPACITY ? after - trace::RING_CAPACITY + 1 : 0;
+
+			for (uint64_t index = std::max(begin, firstIntact); index < end; ++index) {
+				const Span& span = copied[static_cast<size_t>(index - begin)];
+				if (span.start >= since) {
+					out.push_back(span);
+				}
+			}
+		}
+	};
+
+	struct Registry {
+		std::mutex mutex;
+		std::vector<std::shared_ptr<SpanRing>> rings;
+		int nextThreadId = 1;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	// Unregisters the ring when its thread exits; an export already holding it finishes first
+	struct ThreadRing {
+		std::shared_ptr<SpanRing> ring;
+
+		~ThreadRing()
+		{
+			if (ring) {
+				Registry& registry = GetRegistry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				std::erase(registry.rings, ring);
+			}
+		}
+	};
+
+	thread_local ThreadRing t_threadRing;
+
+	SpanRing& LocalRing()
+	{
+		if (!t_threadRing.ring) {
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			t_threadRing.ring = std::make_shared<SpanRing>(registry.nextThreadId++);
+			registry.rings.push_back(t_threadRing.ring);
+		}
+		return *t_threadRing.ring;
+	}
+
+	int64_t Nanoseconds(trace::Clock::time_point time)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+	}
+
+	// trace_event timestamps are microseconds; nanoseconds are kept as three decimals
+	std::string Microseconds(int64_t nanoseconds)
+	{
+		std::string fraction = std::to_string(1000 + nanoseconds % 1000).substr(1);
+		return std::to_string(nanoseconds / 1000) + "." + fraction;
+	}
+
+	std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				escaped += '\\';
+			}
+			if (static_cast<unsigned char>(c) >= 0x20) {
+				escaped += c;
+			}
+		}
+		return escaped;
+	}
+}
+
+void trace::Record(const char* name, Clock::time_point start, Clock::time_point end, const char* argName, uint64_t arg)
+{
+	LocalRing().Push(Span{ name, argName, Nanoseconds(start), Nanoseconds(end), arg });
+}
+
+// Shown as the thread's track name; threads that never set one appear as "thread <n>"
+void trace::SetThreadName(const std::string& name)
+{
+	SpanRing& ring = LocalRing();
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	ring.threadName = name;
+}
+
+// Complete ("X") events of every thread for the spans that started within the window, plus
+// one thread_name record per thread. Timestamps count from the start of the window.
+std::string trace::ExportChromeTrace(Clock::duration window)
+{
+	int64_t since = Nanoseconds(Clock::now()) - std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+
+	std::vector<std::shared_ptr<SpanRing>> rings;
+	std::vector<std::string> threadNames;
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		rings = registry.rings;
+		for (const auto& ring : rings) {
+			threadNames.push_back(ring->threadName);
+		}
+	}
+
+	std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	auto startEvent = [&out, &first](int threadId) {
+		out += first ? "\n" : ",\n";
+		first = false;
+		out += "{\"pid\":1,\"tid\":" + std::to_string(threadId) + ",";
+		};
+
+	std::vector<Span> spans;
+	for (size_t index = 0; index < rings.size(); ++index) {
+		const SpanRing& ring = *rings[index];
+		startEvent(ring.threadId);
+		out += "\"ph\":\"M\",\"name\":\"thread_name\",\"args\":{\"name\":\"" + EscapeJson(threadNames[index]) + "\"}}";
+
+		spans.clear();
+		ring.Collect(since, spans);
+		for (const Span& span : spans) {
+			startEvent(ring.threadId);
+			out += "\"ph\":\"X\",\"name\":\"";
+			out += span.name;
+			out += "\",\"ts\":" + Microseconds(span.start - since) + ",\"dur\":" + Microseconds(std::max<int64_t>(span.end - span.start, 0));
+			if (span.argName) {
+				out += ",\"args\":{\"";
+				out += span.argName;
+				out += "\":" + std::to_string(span.arg) + "}";
+			}
+			out += "}";
+		}
+	}
+
+	out += "\n]}\n";
+	return out;
+}
+
+trace::Scope::Scope(const char* name, const char* argName, uint64_t arg)
+	: m_name(name),
+	m_argName(argName),
+	m_arg(arg),
+	m_start(Clock::now())
+{
+}
+
+trace::Scope::~Scope()
+{
+	Record(m_name, m_start, Clock::now(), m_argName, m_arg);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Span profiler for the tick phases and the serialization around them. Every thread
+// that records gets its own ring of the last RING_CAPACITY spans, written without a
+// lock or an allocation (two clock reads and a few relaxed stores per span), so it is
+// always on. ExportChromeTrace collects the spans of the last few seconds from every
+// ring as Chrome trace_event JSON, which opens in Perfetto or chrome://tracing with
+// one track per thread.
+//
+// Span and argument names must be string literals: only the pointer is stored.
+namespace trace {
+    using Clock = std::chrono::steady_clock;
+
+    const size_t RING_CAPACITY = 2048; // spans kept per thread; about 10 s of a room at 20 ticks per second
+
+    void Record(const char* name, Clock::time_point start, Clock::time_point end, const char* argName = nullptr, uint64_t arg = 0);
+    void SetThreadName(const std::string& name);
+    std::string ExportChromeTrace(Clock::duration window);
+
+    // Records the enclosing scope as one span of the calling thread
+    class Scope
+    {
+    private:
+        // Member Variables
+        const char* m_name;
+        const char* m_argName;
+        uint64_t m_arg;
+        Clock::time_point m_start;
+
+    public:
+        // Constructor and Destructor
+        explicit Scope(const char* name, const char* argName = nullptr, uint64_t arg = 0);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+}
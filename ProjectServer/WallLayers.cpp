@@ -0,0 +1,218 @@
+#include "WallLayers.h"
+#include <bit>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+	// Bits [from, to] (inclusive) of a single word
+	uint64_t RangeMask(int from, int to)
+	{
+		uint64_t high = to >= 63 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << (to + 1)) - 1;
+		uint64_t low = (uint64_t{ 1 } << from) - 1;
+		return high & ~low;
+	}
+}
+
+BitPlane::BitPlane(int height, int width)
+	: m_height(height),
+	m_width(width),
+	m_stride((static_cast<size_t>(width) + 63) / 64),
+	m_words(m_stride * height, 0)
+{}
+
+bool BitPlane::Test(int x, int y) const
+{
+	return (m_words[x * m_stride + y / 64] >> (y % 64)) & 1;
+}
+
+void BitPlane::Set(int x, int y)
+{
+	m_words[x * m_stride + y / 64] |= uint64_t{ 1 } << (y % 64);
+}
+
+void BitPlane::Reset(int x, int y)
+{
+	m_words[x * m_stride + y / 64] &= ~(uint64_t{ 1 } << (y % 64));
+}
+
+void BitPlane::Clear()
+{
+	std::fill(m_words.begin(), m_words.end(), 0);
+}
+
+size_t BitPlane::Count() const
+{
+	size_t count = 0;
+	for (uint64_t word : m_words) {
+		count += std::popcount(word);
+	}
+	return count;
+}
+
+uint64_t* BitPlane::Row(int x)
+{
+	return m_words.data() + x * m_stride;
+}
+
+const uint64_t* BitPlane::Row(int x) const
+{
+	return m_words.data() + x * m_stride;
+}
+
+size_t BitPlane::GetStride() const
+{
+	return m_stride;
+}
+
+WallLayers::WallLayers(int height, int width)
+	: m_height(height),
+	m_width(width),
+	m_breakable(height, width),
+	m_solid(height, width),
+	m_bomb(height, width),
+	m_start(height, width)
+{}
+
+int WallLayers::GetType(int x, int y) const
+{
+	if (m_breakable.Test(x, y)) return 1;
+	if (m_solid.Test(x, y)) return 2;
+	if (m_bomb.Test(x, y)) return 3;
+	return 0;
+}
+
+void WallLayers::SetType(int x, int y, int type)
+{
+	m_breakable.Reset(x, y);
+	m_solid.Reset(x, y);
+	m_bomb.Reset(x, y);
+
+	switch (type) {
+	case 1:
+		m_breakable.Set(x, y);
+		break;
+	case 2:
+		m_solid.Set(x, y);
+		break;
+	case 3:
+		m_bomb.Set(x, y);
+		break;
+	default:
+		break;
+	}
+}
+
+bool WallLayers::IsWall(int x, int y) const
+{
+	return m_breakable.Test(x, y) || m_solid.Test(x, y) || m_bomb.Test(x, y);
+}
+
+bool WallLayers::IsStart(int x, int y) const
+{
+	return m_start.Test(x, y);
+}
+
+void WallLayers::SetStart(int x, int y, bool isStart)
+{
+	if (isStart) {
+		m_start.Set(x, y);
+	}
+	else {
+		m_start.Reset(x, y);
+	}
+}
+
+void WallLayers::ClearStarts()
+{
+	m_start.Clear();
+}
+
+// Rebuilds the wall planes from row-major cell codes; start positions are left untouched
+void WallLayers::Load(std::span<const uint8_t> cells)
+{
+	// Every word of every plane is assembled in registers and stored once
+	for (int i = 0; i < m_height; ++i) {
+		const uint8_t* row = cells.data() + static_cast<size_t>(i) * m_width;
+		uint64_t* breakable = m_breakable.Row(i);
+		uint64_t* solid = m_solid.Row(i);
+		uint64_t* bomb = m_bomb.Row(i);
+
+		for (size_t word = 0; word < m_breakable.GetStride(); ++word) {
+			uint64_t breakableBits = 0, solidBits = 0, bombBits = 0;
+			int first = static_cast<int>(word * 64);
+			int last = std::min(first + 64, m_width);
+			for (int j = first; j < last; ++j) {
+				uint64_t bit = uint64_t{ 1 } << (j - first);
+				breakableBits |= row[j] == 1 ? bit : 0;
+				solidBits |= row[j] == 2 ? bit : 0;
+				bombBits |= row[j] == 3 ? bit : 0;
+			}
+			breakable[word] = breakableBits;
+			solid[word] = solidBits;
+			bomb[word] = bombBits;
+		}
+	}
+}
+
+size_t WallLayers::CountWalls(int type) const
+{
+	const BitPlane* plane = PlaneFor(type);
+	if (plane) {
+		return plane->Count();
+	}
+	return m_breakable.Count() + m_solid.Count() + m_bomb.Count();
+}
+
+std::vector<Wall> WallLayers::GetWalls() const
+{
+	std::vector<Wall> walls;
+	walls.reserve(CountWalls(0));
+	for (int i = 0; i < m_height; ++i) {
+		for (int j = 0; j < m_width; ++j) {
+			int type = GetType(i, j);
+			if (type != 0) {
+				walls.emplace_back(j, i, type);
+			}
+		}
+	}
+	return walls;
+}
+
+// Breakable walls within Manhattan distance radius of (x, y), found a word of the plane at a time
+std::vector<std::pair<int, int>> WallLayers::FindBlast(int x, int y, int radius) const
+{
+	std::vector<std::pair<int, int>> walls;
+
+	for (int i = std::max(0, x - radius); i <= std::min(m_height - 1, x + radius); ++i) {
+		int reach = radius - std::abs(x - i);
+		int from = std::max(0, y - reach);
+		int to = std::min(m_width - 1, y + reach);
+		if (from > to) {
+			continue;
+		}
+
+		const uint64_t* row = m_breakable.Row(i);
+		for (size_t word = from / 64; word <= static_cast<size_t>(to / 64); ++word) {
+			int low = word == static_cast<size_t>(from / 64) ? from % 64 : 0;
+			int high = word == static_cast<size_t>(to / 64) ? to % 64 : 63;
+			for (uint64_t bits = row[word] & RangeMask(low, high); bits; bits &= bits - 1) {
+				walls.emplace_back(i, static_cast<int>(word * 64 + std::countr_zero(bits)));
+			}
+		}
+	}
+	return walls;
+}
+
+const BitPlane* WallLayers::PlaneFor(int type) const
+{
+	switch (type) {
+	case 1:
+		return &m_breakable;
+	case 2:
+		return &m_solid;
+	case 3:
+		return &m_bomb;
+	default:
+		return nullptr;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+import Wall;
+
+using boardElements::Wall;
+
+// One bit per board cell, rows padded to whole 64-bit words
+class BitPlane {
+private:
+    // Member Variables
+    int m_height;
+    int m_width;
+    size_t m_stride; // words per row
+    std::vector<uint64_t> m_words;
+
+public:
+    // Constructor
+    BitPlane(int height, int width);
+
+    // Bit Access
+    bool Test(int x, int y) const;
+    void Set(int x, int y);
+    void Reset(int x, int y);
+    void Clear();
+
+    // Bulk Access
+    size_t Count() const;
+    uint64_t* Row(int x);
+    const uint64_t* Row(int x) const;
+    size_t GetStride() const;
+};
+
+// Per-type bit planes for walls (breakable, solid, bomb) and start positions.
+// For walls they are an index over the board's cell codes, which the board keeps
+// in step on every write; Wall objects are only materialized on demand from them.
+class WallLayers {
+private:
+    // Member Variables
+    int m_height;
+    int m_width;
+    BitPlane m_breakable; // type 1
+    BitPlane m_solid;     // type 2
+    BitPlane m_bomb;      // type 3
+    BitPlane m_start;
+
+public:
+    // Constructor
+    WallLayers(int height, int width);
+
+    // Cell Access
+    int GetType(int x, int y) const;
+    void SetType(int x, int y, int type);
+    bool IsWall(int x, int y) const;
+    bool IsStart(int x, int y) const;
+    void SetStart(int x, int y, bool isStart);
+    void ClearStarts();
+    void Load(std::span<const uint8_t> cells);
+
+    // Bulk Queries
+    size_t CountWalls(int type) const;
+    std::vector<Wall> GetWalls() const;
+    std::vector<std::pair<int, int>> FindBlast(int x, int y, int radius) const;
+
+private:
+    const BitPlane* PlaneFor(int type) const;
+};
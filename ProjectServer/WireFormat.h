@@ -0,0 +1,222 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Binary encoding of board, tank and bullet state, shared by the server and the SDL client.
+// All integers are little-endian and every record has a fixed width, so a decoder can
+// read straight out of the response buffer without allocating.
+//
+// Layout:
+//   Header   (HEADER_SIZE bytes)
+//   Cells    (height * width * bitsPerCell bits, row-major, rounded up to whole bytes)
+//   Tanks    (tankCount * TANK_RECORD_SIZE bytes)
+//   Bullets  (bulletCount * BULLET_RECORD_SIZE bytes)
+namespace wire {
+    const uint16_t MAGIC = 0x4254; // "TB"
+    const uint8_t FORMAT_VERSION = 1;
+    const char* const CONTENT_TYPE = "application/octet-stream";
+
+    const size_t HEADER_SIZE = 24;
+    const size_t TICK_OFFSET = 12; // of the header's tick, for rewriting it in an encoded message
+    const size_t TANK_RECORD_SIZE = 8;
+    const size_t BULLET_RECORD_SIZE = 12;
+
+    // Cell codes as sent on the wire; bomb walls are hidden and go out as Empty
+    enum class Cell : uint8_t { Empty = 0, Breakable = 1, Solid = 2 };
+
+    struct Header {
+        uint8_t formatVersion;
+        uint8_t bitsPerCell; // 2 or 4, 0 when the message carries no cells
+        uint16_t height;
+        uint16_t width;
+        uint16_t tankCount;
+        uint16_t bulletCount;
+        uint64_t tick;
+    };
+
+    struct TankRecord {
+        uint8_t slot;
+        uint8_t direction;
+        uint8_t lives;
+        uint8_t alive;
+        uint16_t x; // row
+        uint16_t y; // column
+    };
+
+    struct BulletRecord {
+        uint16_t slot;
+        uint8_t owner;
+        uint8_t direction;
+        float x; // bordered column
+        float y; // bordered row
+    };
+
+    // Writing
+
+    inline void PutU16(std::string& out, uint16_t value)
+    {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    inline void PutU32(std::string& out, uint32_t value)
+    {
+        PutU16(out, static_cast<uint16_t>(value & 0xFFFF));
+        PutU16(out, static_cast<uint16_t>(value >> 16));
+    }
+
+    inline void PutU64(std::string& out, uint64_t value)
+    {
+        PutU32(out, static_cast<uint32_t>(value & 0xFFFFFFFF));
+        PutU32(out, static_cast<uint32_t>(value >> 32));
+    }
+
+    inline void PutF32(std::string& out, float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        PutU32(out, bits);
+    }
+
+    inline void PutHeader(std::string& out, const Header& header)
+    {
+        PutU16(out, MAGIC);
+        out.push_back(static_cast<char>(header.formatVersion));
+        out.push_back(static_cast<char>(header.bitsPerCell));
+        PutU16(out, header.height);
+        PutU16(out, header.width);
+        PutU16(out, header.tankCount);
+        PutU16(out, header.bulletCount);
+        PutU64(out, header.tick);
+        PutU32(out, 0); // reserved
+    }
+
+    // Overwrites the tick of a message that is already encoded
+    inline void SetTick(std::string& message, uint64_t tick)
+    {
+        for (size_t byte = 0; byte < 8; ++byte) {
+            message[TICK_OFFSET + byte] = static_cast<char>((tick >> (byte * 8)) & 0xFF);
+        }
+    }
+
+    inline void PutTank(std::string& out, const TankRecord& tank)
+    {
+        out.push_back(static_cast<char>(tank.slot));
+        out.push_back(static_cast<char>(tank.direction));
+        out.push_back(static_cast<char>(tank.lives));
+        out.push_back(static_cast<char>(tank.alive));
+        PutU16(out, tank.x);
+        PutU16(out, tank.y);
+    }
+
+    inline void PutBullet(std::string& out, const BulletRecord& bullet)
+    {
+        PutU16(out, bullet.slot);
+        out.push_back(static_cast<char>(bullet.owner));
+        out.push_back(static_cast<char>(bullet.direction));
+        PutF32(out, bullet.x);
+        PutF32(out, bullet.y);
+    }
+
+    inline size_t CellBytes(const Header& header)
+    {
+        return (static_cast<size_t>(header.height) * header.width * header.bitsPerCell + 7) / 8;
+    }
+
+    // Reading
+
+    inline uint16_t GetU16(const uint8_t* data)
+    {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    inline uint32_t GetU32(const uint8_t* data)
+    {
+        return GetU16(data) | (static_cast<uint32_t>(GetU16(data + 2)) << 16);
+    }
+
+    inline uint64_t GetU64(const uint8_t* data)
+    {
+        return GetU32(data) | (static_cast<uint64_t>(GetU32(data + 4)) << 32);
+    }
+
+    inline float GetF32(const uint8_t* data)
+    {
+        uint32_t bits = GetU32(data);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Non-owning view over an encoded message; the buffer must outlive it
+    class MessageView {
+    private:
+        // Member Variables
+        const uint8_t* m_data = nullptr;
+        Header m_header{};
+        size_t m_tanksOffset = 0;
+        size_t m_bulletsOffset = 0;
+
+    public:
+        // Validates the header and the total length; returns false on a malformed message
+        bool Parse(std::string_view buffer)
+        {
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data());
+            if (buffer.size() < HEADER_SIZE || GetU16(data) != MAGIC || data[2] != FORMAT_VERSION) {
+                return false;
+            }
+
+            Header header;
+            header.formatVersion = data[2];
+            header.bitsPerCell = data[3];
+            header.height = GetU16(data + 4);
+            header.width = GetU16(data + 6);
+            header.tankCount = GetU16(data + 8);
+            header.bulletCount = GetU16(data + 10);
+            header.tick = GetU64(data + 12);
+            if (header.bitsPerCell != 0 && header.bitsPerCell != 2 && header.bitsPerCell != 4) {
+                return false;
+            }
+
+            size_t tanksOffset = HEADER_SIZE + CellBytes(header);
+            size_t bulletsOffset = tanksOffset + header.tankCount * TANK_RECORD_SIZE;
+            if (buffer.size() < bulletsOffset + header.bulletCount * BULLET_RECORD_SIZE) {
+                return false;
+            }
+
+            m_data = data;
+            m_header = header;
+            m_tanksOffset = tanksOffset;
+            m_bulletsOffset = bulletsOffset;
+            return true;
+        }
+
+        const Header& GetHeader() const
+        {
+            return m_header;
+        }
+
+        // x = row, y = column, both without the border
+        Cell CellAt(int x, int y) const
+        {
+            size_t bit = (static_cast<size_t>(x) * m_header.width + y) * m_header.bitsPerCell;
+            uint8_t mask = static_cast<uint8_t>((1 << m_header.bitsPerCell) - 1);
+            return static_cast<Cell>((m_data[HEADER_SIZE + bit / 8] >> (bit % 8)) & mask);
+        }
+
+        TankRecord TankAt(size_t index) const
+        {
+            const uint8_t* record = m_data + m_tanksOffset + index * TANK_RECORD_SIZE;
+            return TankRecord{ record[0], record[1], record[2], record[3], GetU16(record + 4), GetU16(record + 6) };
+        }
+
+        BulletRecord BulletAt(size_t index) const
+        {
+            const uint8_t* record = m_data + m_bulletsOffset + index * BULLET_RECORD_SIZE;
+            return BulletRecord{ GetU16(record), record[2], record[3], GetF32(record + 4), GetF32(record + 8) };
+        }
+    };
+}
@@ -6,27 +6,72 @@
 #include <mutex>
 #include <fstream>
 #include <atomic>
+#include <cstdlib>
+#include <sstream>
+#include <optional>
+#include <charconv>
+#include <algorithm>
 
 #include "Board.h"
+#include "ActionLog.h"
+#include "RoomRegistry.h"
+#include "MapPool.h"
+#include "MapCache.h"
+#include "SubscriberHub.h"
+#include "WireFormat.h"
 #include "PlayerDatabase.h"
+#include "ServerMetrics.h"
+#include "TraceRecorder.h"
 #include "..\PasswordManager\PasswordManager.h" 
 
 std::atomic<int> gameTimer(0);
-std::mutex gameMutex;
+std::mutex storageMutex; // the player database is shared by every room; held around every storage call
 using namespace http;
 using namespace sql;
 
+const int DEFAULT_ROOM = 0; // served by the routes without a /room/<id> prefix
+const int TICKS_PER_SECOND = 20;
+const size_t MAX_ROOMS = 512;
+const auto JOIN_TIMEOUT = std::chrono::milliseconds(1000); // for a queued join to be applied before /join gives up
+const int MIN_ROOM_SIDE = 5;
+const int MAX_ROOM_SIDE = 128; // for rooms clients create; MAX_ROOMS of them stay within a few hundred MB
+const size_t ACTION_LOG_CAPACITY = 8192; // records queued before new ones are dropped
+const size_t ACTION_LOG_BATCH = 256;     // records that trigger an early flush
+const auto ACTION_LOG_FLUSH_INTERVAL = std::chrono::milliseconds(250);
+const size_t MAP_POOL_BUCKET_CAPACITY = 2; // ready maps per (difficulty, size); only the default room size is pooled
+const size_t MAP_POOL_WORKERS = 1;         // background generators; rooms keep the other cores
+const size_t MAP_CACHE_BYTES = 64 * 1024 * 1024;       // cells of recently used maps kept in memory
+const size_t MAP_CACHE_DISK_BYTES = 512 * 1024 * 1024; // map files kept in the disk tier, if there is one
+const double DEFAULT_TRACE_SECONDS = 5.0;
+const double MAX_TRACE_SECONDS = 60.0; // older spans have usually been overwritten anyway (see trace::RING_CAPACITY)
+
 int main() {
-	crow::SimpleApp app;
+	ServerMetrics metrics; // declared first so the app and the rooms recording into it go away before it
+	crow::App<MetricsMiddleware> app;
+	app.get_middleware<MetricsMiddleware>().metrics = &metrics;
 	Storage storage = createStorage("players.sqlite");
 	storage.sync_schema();
-	srand(std::time(0));
 
 	int m = 20, n = 20, d = 1;
 
-	Board b(m, n, d);
-	b.SetDifficulty();
-	b.GenerateBoard();
+	ActionLog actionLog("log.txt", ACTION_LOG_CAPACITY, ACTION_LOG_BATCH, ACTION_LOG_FLUSH_INTERVAL);
+	SubscriberHub subscribers; // declared before the rooms so it outlives their tick listeners
+	MapPool mapPool(MAP_POOL_BUCKET_CAPACITY, MAP_POOL_WORKERS);
+	for (int difficulty = 1; difficulty <= 4; ++difficulty) {
+		mapPool.Warm(m, n, difficulty); // rooms of the default size then start on a pooled map; other sizes generate their own
+	}
+	const char* mapCacheDirectory = std::getenv("BATTLECITY_MAP_CACHE_DIR"); // optional disk tier
+	MapCache mapCache(MAP_CACHE_BYTES, mapCacheDirectory ? mapCacheDirectory : "", MAP_CACHE_DISK_BYTES);
+	RoomRegistry rooms(TICKS_PER_SECOND, MAX_ROOMS);
+	rooms.SetMapPool(&mapPool);
+	rooms.SetMapCache(&mapCache);
+	rooms.SetHistograms(&metrics.GetTickDuration(), &metrics.GetStateLockWait());
+	if (const char* replayDirectory = std::getenv("BATTLECITY_REPLAY_DIR")) {
+		rooms.SetReplayDirectory(replayDirectory); // every room records its seed and inputs for ProjectReplay
+	}
+	auto defaultRoom = std::make_shared<Board>(m, n, d);
+	defaultRoom->SetDifficulty();
+	rooms.AddRoom(DEFAULT_ROOM, defaultRoom);
 
 	std::thread([&]() {
 		while (true) {
@@ -35,26 +80,323 @@ int main() {
 		}
 		}).detach();
 
-	CROW_ROUTE(app, "/time").methods("GET"_method)([&]() {
-		return crow::response(std::to_string(gameTimer.load()));
-		});
+	// Runs one player database call and records how long SQLite took
+	auto timedQuery = [&metrics](auto&& query) {
+		auto start = std::chrono::steady_clock::now();
+		auto result = query();
+		metrics.GetDatabaseQueries().Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+		return result;
+		};
+
+	// Looks the room up and runs the handler on it, or answers 404
+	auto withRoom = [&rooms](int roomId, auto&& handler) {
+		std::shared_ptr<Board> room = rooms.GetRoom(roomId);
+		if (!room) {
+			return crow::response(404, "Room not found");
+		}
+		return handler(*room);
+		};
+
+	auto tickStatsResponse = [](Board& b) {
+		crow::json::wvalue response;
+		response["tickRate"] = b.GetTickRate();
+		response["tickCount"] = b.GetTickCount();
+		response["lastTickMicroseconds"] = b.GetLastTickDuration();
+		response["maxTickMicroseconds"] = b.GetMaxTickDuration();
+		response["tickOverruns"] = b.GetTickOverruns();
+		return crow::response(response);
+		};
+
+	auto inputStatsResponse = [](Board& b) {
+		const InputQueue& inputs = b.GetInputQueue();
+		crow::json::wvalue response;
+		response["capacity"] = inputs.GetCapacity();
+		response["depth"] = inputs.GetDepth();
+		response["enqueued"] = inputs.GetEnqueuedCount();
+		response["dropped"] = inputs.GetDroppedCount();
+		response["applied"] = inputs.GetAppliedCount();
+		response["lastLatencyMicroseconds"] = inputs.GetLastLatency();
+		response["meanLatencyMicroseconds"] = inputs.GetMeanLatency();
+		response["maxLatencyMicroseconds"] = inputs.GetMaxLatency();
+		return crow::response(response);
+		};
+
+	// Binary encoding is opt-in: "Accept: application/octet-stream" or ?format=binary
+	auto wantsBinary = [](const crow::request& req) {
+		const char* format = req.url_params.get("format");
+		if (format != nullptr) {
+			return std::string(format) == "binary";
+		}
+		return req.get_header_value("Accept").find(wire::CONTENT_TYPE) != std::string::npos;
+		};
+
+	auto binaryResponse = [](std::string body) {
+		crow::response response(200, std::move(body));
+		response.set_header("Content-Type", wire::CONTENT_TYPE);
+		return response;
+		};
+
+	// Read-only routes serve the snapshot published by the last tick and never take the state lock
+	auto bulletsResponse = [&wantsBinary, &binaryResponse](Board& b, const crow::request& req) {
+		std::shared_ptr<const BoardSnapshot> snapshot = b.GetLatestSnapshot();
+		if (wantsBinary(req)) {
+			std::string body;
+			snapshot->EncodeBullets(body);
+			return binaryResponse(std::move(body));
+		}
+		return crow::response(snapshot->GetBulletCoords());
+		};
+
+	auto joinResponse = [&storage, &timedQuery](Board& b, const crow::request& req) {
+		auto jsonData = crow::json::load(req.body);
+
+		if (!jsonData || !jsonData.has("playerName") || !jsonData.has("password")) {
+			crow::json::wvalue errorResponse;
+			errorResponse["error"] = "Invalid request payload";
+			std::cerr << "Error: " << errorResponse.dump() << std::endl;
+			return crow::response(400, errorResponse.dump());
+		}
+
+		std::string playerName = jsonData["playerName"].s();
+		std::string playerPassword = jsonData["password"].s();
+
+		// Queues the player's tank for this room unless it is already in it and waits for the join to be applied;
+		// returns the HTTP status, with 409 when a concurrent join filled the room first
+		auto enterRoom = [&b](const Player& player, crow::json::wvalue& response) {
+			std::shared_ptr<const BoardSnapshot> snapshot = b.GetLatestSnapshot();
+			response["board"] = snapshot->GetPlayerState();
+			if (snapshot->HasPlayer(player.GetId())) {
+				return 200;
+			}
+			if (snapshot->IsFull()) {
+				return 409;
+			}
+
+			InputCommand join;
+			join.type = InputType::Join;
+			join.playerId = player.GetId();
+			join.name = player.GetName();
+			join.highScore = player.GetHighScore();
+			join.lives = 3;
+			if (!b.SubmitInput(std::move(join))) {
+				return 503;
+			}
+
+			// A tick only drains what was queued when it started, so the join is applied by the second tick after this snapshot
+			uint64_t appliedBy = snapshot->GetTick() + 2;
+			snapshot = b.WaitForSnapshot(appliedBy, JOIN_TIMEOUT);
+			response["board"] = snapshot->GetPlayerState();
+			if (snapshot->HasPlayer(player.GetId())) {
+				return 200;
+			}
+			return snapshot->GetTick() >= appliedBy ? 409 : 503;
+			};
+
+		auto rejectedResponse = [](int status) {
+			crow::json::wvalue errorResponse;
+			errorResponse["error"] = status == 409 ? "Room is full" : "Room is busy, try again";
+			return crow::response(status, errorResponse.dump());
+			};
+
+		// Held from the lookup to the insert, so two joins under the same new name insert it once
+		std::unique_lock<std::mutex> storageLock(storageMutex);
+		std::vector<Player> existingPlayer = timedQuery([&]() { return storage.get_all<Player>(where(c(&Player::m_name) == playerName)); });
+		if (!existingPlayer.empty()) {
+			storageLock.unlock();
+
+			// Player exists, validate the password
+			const auto& player = existingPlayer.front();
 
-	CROW_ROUTE(app, "/bulletsCoord").methods("GET"_method)([&b]() {
-		crow::json::wvalue jsonResponse;
-		crow::json::wvalue::list bulletsList;
+			if (player.GetPassword() == playerPassword) {
+				crow::json::wvalue response;
+				response["message"] = "Player already exists";
+				response["playerId"] = player.GetId();
+				if (int status = enterRoom(player, response); status != 200) {
+					return rejectedResponse(status);
+				}
+				response["welcomeMessage"] = "Welcome back to the game, " + playerName + "!";
+				std::cout << "Joining existing player: " << playerName << " with ID: " << player.GetId() << std::endl;
+				return crow::response(response.dump());
+			}
+			else {
+				crow::json::wvalue errorResponse;
+				errorResponse["error"] = "Incorrect password";
+				std::cout << "Incorrect password for player: " << playerName << std::endl;
+				return crow::response(403, errorResponse.dump());
+			}
+		}
 
-		for (const auto bullet : b.GetBullets()) {
-			crow::json::wvalue bulletJson;
-			bulletJson["coordX"] = (*bullet).GetX();
-			bulletJson["coordY"] = (*bullet).GetY();
-			bulletsList.push_back(std::move(bulletJson));
+		if (!VerifyPassword(playerPassword)) {
+			crow::json::wvalue errorResponse;
+			errorResponse["error"] = "Password does not meet security requirements. Please try again.";
+			std::cerr << "Error: " << errorResponse.dump() << std::endl;
+			return crow::response(400, errorResponse.dump());
 		}
-		jsonResponse["bullets"] = std::move(bulletsList);
-		return crow::response(jsonResponse);
+
+		// Insert a new record
+		try {
+			auto playerId = timedQuery([&]() {
+				return storage.insert(Player{
+					0,
+					playerName,
+					playerPassword,
+					0,
+					3,
+					0
+					});
+				});
+
+			Player playerEntry = timedQuery([&]() { return storage.get<Player>(playerId); });
+			storageLock.unlock();
+			std::cout << "Inserted new player: " << playerName << " with ID: " << playerEntry.GetId() << std::endl;
+
+			crow::json::wvalue response;
+			response["message"] = "Player added";
+			response["playerId"] = playerEntry.GetId();
+			if (int status = enterRoom(playerEntry, response); status != 200) {
+				return rejectedResponse(status);
+			}
+			response["welcomeMessage"] = "Welcome to the game, " + playerName + "!";
+
+			return crow::response(response.dump());
+		}
+		catch (const std::exception& e) {
+			crow::json::wvalue errorResponse;
+			errorResponse["error"] = "Failed to insert player";
+			errorResponse["details"] = e.what();
+			std::cerr << "Error: " << errorResponse.dump() << std::endl;
+			return crow::response(500, errorResponse.dump());
+		}
+		};
+
+	// With ?since=<version> only the changes after that version (or a keyframe) are sent
+	auto deltaResponse = [](Board& b, const char* since) {
+		return crow::response(b.GetBoardDelta(std::strtoull(since, nullptr, 10)).dump());
+		};
+
+	// The full state is encoded once per version by the snapshot and tagged with it, so an
+	// unchanged board costs neither a serialization nor a body when the client sends If-None-Match.
+	// Deltas read the change log and are the only part that needs the state lock.
+	auto gameResponse = [&deltaResponse, &wantsBinary](Board& b, const crow::request& req) {
+		if (const char* since = req.url_params.get("since")) {
+			auto stateLock = b.LockState();
+			return deltaResponse(b, since);
+		}
+
+		bool binary = wantsBinary(req);
+		std::shared_ptr<const BoardSnapshot> snapshot = b.GetLatestSnapshot();
+		std::string tag = snapshot->GetStateTag(binary);
+		if (req.get_header_value("If-None-Match").find(tag) != std::string::npos) {
+			crow::response notModified(304);
+			notModified.set_header("ETag", tag);
+			return notModified;
+		}
+
+		crow::response response(200, snapshot->GetEncodedBoardState(binary));
+		response.set_header("ETag", tag);
+		if (binary) {
+			response.set_header("Content-Type", wire::CONTENT_TYPE);
+		}
+		return response;
+		};
+
+	// Player Log: queued for the background writer, never blocks the request
+	auto logAction = [&actionLog](int playerId, const std::string& key) {
+		actionLog.Log(playerId, key);
+		};
+
+	// w, a, s, d move and f shoots; anything else is rejected before it reaches the room
+	auto parseAction = [](int playerId, const std::string& key) -> std::optional<InputCommand> {
+		if (playerId < 0 || key.size() != 1 || std::string("wasdfWASDF").find(key[0]) == std::string::npos) {
+			return std::nullopt;
+		}
+
+		InputCommand command;
+		command.type = key[0] == 'f' || key[0] == 'F' ? InputType::Shoot : InputType::Move;
+		command.playerId = playerId;
+		command.key = key[0];
+		return command;
+		};
+
+	// The input is queued for the room's next tick, so the state sent back (202) does not include it yet
+	auto actionResponse = [&logAction, &parseAction, &deltaResponse, &wantsBinary, &binaryResponse](Board& b, const crow::request& req, int playerId, const std::string& key) {
+		std::optional<InputCommand> command = parseAction(playerId, key);
+		if (!command) {
+			return crow::response(400, "Invalid action");
+		}
+
+		logAction(playerId, key);
+		if (!b.SubmitInput(std::move(*command))) {
+			return crow::response(503, "Too many pending inputs");
+		}
+
+		crow::response response;
+		if (wantsBinary(req)) {
+			response = binaryResponse(b.GetLatestSnapshot()->GetEncodedBoardState(true));
+		}
+		else if (const char* since = req.url_params.get("since")) {
+			auto stateLock = b.LockState();
+			response = deltaResponse(b, since);
+		}
+		else {
+			response = crow::response(b.GetLatestSnapshot()->GetEncodedBoardState(false));
+		}
+		response.code = 202;
+		return response;
+		};
+
+	// ?fields=board,tanks,bullets,scores,time selects the sections; all of them by default
+	auto snapshotResponse = [&wantsBinary, &binaryResponse](Board& b, const crow::request& req) {
+		uint32_t fields = SNAPSHOT_ALL;
+		if (const char* requested = req.url_params.get("fields")) {
+			static const std::unordered_map<std::string, uint32_t> fieldNames = {
+				{ "board", SNAPSHOT_BOARD },
+				{ "tanks", SNAPSHOT_TANKS },
+				{ "bullets", SNAPSHOT_BULLETS },
+				{ "scores", SNAPSHOT_SCORES },
+				{ "time", SNAPSHOT_TIME },
+			};
+
+			fields = 0;
+			std::stringstream names(requested);
+			std::string name;
+			while (std::getline(names, name, ',')) {
+				auto field = fieldNames.find(name);
+				if (field == fieldNames.end()) {
+					return crow::response(400, "Unknown snapshot field: " + name);
+				}
+				fields |= field->second;
+			}
+		}
+
+		std::shared_ptr<const BoardSnapshot> snapshot = b.GetLatestSnapshot();
+		if (wantsBinary(req)) {
+			std::string body;
+			snapshot->EncodeSnapshot(body, fields);
+			return binaryResponse(std::move(body));
+		}
+		return crow::response(snapshot->GetSnapshot(fields, gameTimer.load()).dump());
+		};
+
+	// The map is taken from the pool (or generated on a miss) before the state lock, so ticks never wait on generation
+	auto changeDifficultyResponse = [&mapPool, &mapCache](Board& b, int difficulty) {
+		if (difficulty < 1 || difficulty > 4) {
+			return crow::response(400, "Invalid difficulty level");
+		}
+
+		std::shared_ptr<const mapgen::Map> map = mapCache.Insert(mapPool.Take(b.GetHeight(), b.GetWidth(), difficulty));
+		auto stateLock = b.LockState();
+		b.LoadMap(*map);
+
+		return crow::response(200, "Difficulty updated and board regenerated");
+		};
+
+	CROW_ROUTE(app, "/time").methods("GET"_method)([&]() {
+		return crow::response(std::to_string(gameTimer.load()));
 		});
 
 	CROW_ROUTE(app, "/player").methods("POST"_method, "GET"_method)
-		([&storage](const crow::request& req) {
+		([&storage, &timedQuery](const crow::request& req) {
 		if (req.method == crow::HTTPMethod::POST) {
 			auto body = crow::json::load(req.body);
 			if (!body) {
@@ -69,7 +411,9 @@ int main() {
 			std::string password = body["password"].s();
 
 			try {
-				auto existingPlayer = storage.get_all<Player>(where(c(&Player::m_name) == name));
+				// Held from the lookup to the insert, like in /join
+				std::lock_guard<std::mutex> storageLock(storageMutex);
+				auto existingPlayer = timedQuery([&]() { return storage.get_all<Player>(where(c(&Player::m_name) == name)); });
 
 				if (!existingPlayer.empty()) {
 					const auto& player = existingPlayer.front();
@@ -86,16 +430,18 @@ int main() {
 					}
 				}
 
-				auto playerId = storage.insert(Player{
-					0,
-					name,
-					password,
-					0,
-					0,
-					0
+				auto playerId = timedQuery([&]() {
+					return storage.insert(Player{
+						0,
+						name,
+						password,
+						0,
+						0,
+						0
+						});
 					});
 
-				auto playerEntry = storage.get<Player>(playerId);
+				auto playerEntry = timedQuery([&]() { return storage.get<Player>(playerId); });
 
 				crow::json::wvalue response;
 				response["id"] = playerEntry.GetId();
@@ -109,7 +455,11 @@ int main() {
 		}
 		else if (req.method == crow::HTTPMethod::GET) {
 			try {
-				auto allPlayers = storage.get_all<Player>();
+				std::vector<Player> allPlayers;
+				{
+					std::lock_guard<std::mutex> storageLock(storageMutex);
+					allPlayers = timedQuery([&]() { return storage.get_all<Player>(); });
+				}
 
 				// Create a JSON array to hold player data
 				crow::json::wvalue response;
@@ -133,161 +483,391 @@ int main() {
 		return crow::response(405, "Method Not Allowed");
 			});
 
-	CROW_ROUTE(app, "/join").methods("POST"_method)([&b, &storage](const crow::request& req) {
-		std::lock_guard<std::mutex> lock(gameMutex); // Protect the shared state
-		auto jsonData = crow::json::load(req.body);
+	CROW_ROUTE(app, "/highScore").methods("GET"_method)([&storage, &timedQuery](const crow::request& req) {
+		std::string playerName = req.url_params.get("name");
 
-		if (!jsonData || !jsonData.has("playerName") || !jsonData.has("password")) {
-			crow::json::wvalue errorResponse;
-			errorResponse["error"] = "Invalid request payload";
-			std::cerr << "Error: " << errorResponse.dump() << std::endl;
-			return crow::response(400, errorResponse.dump());
+		if (playerName.empty()) {
+			return crow::response(400, "Missing 'name' parameter");
 		}
 
-		std::string playerName = jsonData["playerName"].s();
-		std::string playerPassword = jsonData["password"].s();
-
-		auto existingPlayer = storage.get_all<Player>(where(c(&Player::m_name) == playerName));
-		if (!existingPlayer.empty()) {
-			// Player exists, validate the password
-			const auto& player = existingPlayer.front();
-
-			if (player.GetPassword() == playerPassword) {
+		try {
+			std::vector<Player> player;
+			{
+				std::lock_guard<std::mutex> storageLock(storageMutex);
+				player = timedQuery([&]() { return storage.get_all<Player>(where(c(&Player::m_name) == playerName)); });
+			}
+			if (!player.empty()) {
+				int score = player.front().GetScore();
+				int highScore = player.front().GetHighScore();
 				crow::json::wvalue response;
-				response["message"] = "Player already exists";
-				response["playerId"] = player.GetId();
-				response["board"] = b.GetPlayerState();
-				response["welcomeMessage"] = "Welcome back to the game, " + playerName + "!";
-				std::cout << "Joining existing player: " << playerName << " with ID: " << player.GetId() << std::endl;
-				return crow::response(response.dump());
+				response["score"] = score;
+				response["highScore"] = highScore;
+				return crow::response(response);
 			}
 			else {
-				crow::json::wvalue errorResponse;
-				errorResponse["error"] = "Incorrect password";
-				std::cout << "Incorrect password for player: " << playerName << std::endl;
-				return crow::response(403, errorResponse.dump());
+				return crow::response(404, "Player not found");
 			}
 		}
-
-		if (!VerifyPassword(playerPassword)) {
-			crow::json::wvalue errorResponse;
-			errorResponse["error"] = "Password does not meet security requirements. Please try again.";
-			std::cerr << "Error: " << errorResponse.dump() << std::endl;
-			return crow::response(400, errorResponse.dump());
+		catch (const std::exception& e) {
+			return crow::response(500, "Server error: " + std::string(e.what()));
 		}
+		});
 
-		// Insert a new record
-		try {
-			auto playerId = storage.insert(Player{
-				0,
-				playerName,
-				playerPassword,
-				0,
-				3,
-				0
-				});
+	CROW_ROUTE(app, "/logStats").methods("GET"_method)([&actionLog]() {
+		crow::json::wvalue response;
+		response["capacity"] = actionLog.GetCapacity();
+		response["logged"] = actionLog.GetLoggedCount();
+		response["dropped"] = actionLog.GetDroppedCount();
+		response["written"] = actionLog.GetWrittenCount();
+		response["flushes"] = actionLog.GetFlushCount();
+		return crow::response(response);
+		});
 
-			auto playerEntry = storage.get<Player>(playerId);
-			std::cout << "Inserted new player: " << playerName << " with ID: " << playerEntry.GetId() << std::endl;
+	// Default room
+	CROW_ROUTE(app, "/tickStats").methods("GET"_method)([&]() {
+		return withRoom(DEFAULT_ROOM, tickStatsResponse);
+		});
 
-			crow::json::wvalue response;
-			response["message"] = "Player added";
-			response["playerId"] = playerEntry.GetId();
-			response["board"] = b.GetPlayerState();
-			response["welcomeMessage"] = "Welcome to the game, " + playerName + "!";
+	CROW_ROUTE(app, "/inputStats").methods("GET"_method)([&]() {
+		return withRoom(DEFAULT_ROOM, inputStatsResponse);
+		});
 
-			Tank newPlayer(playerEntry.GetId(), playerName, playerPassword, 0, 3, 0);
-			b.InsertPlayer(newPlayer);
+	// Walls as generated, by the mapHash found in snapshots and keyframes. The content never
+	// changes for a hash, so clients fetch it once and then only follow state changes.
+	CROW_ROUTE(app, "/map/<string>").methods("GET"_method)([&mapCache](const crow::request& req, std::string hashText) {
+		uint64_t hash;
+		auto [end, error] = std::from_chars(hashText.data(), hashText.data() + hashText.size(), hash, 16);
+		if (error != std::errc() || end != hashText.data() + hashText.size()) {
+			return crow::response(400, "Invalid map hash");
+		}
 
-			return crow::response(response.dump());
+		std::string tag = "\"" + mapgen::FormatHash(hash) + "\"";
+		if (req.get_header_value("If-None-Match") == tag) {
+			return crow::response(304);
 		}
-		catch (const std::exception& e) {
-			crow::json::wvalue errorResponse;
-			errorResponse["error"] = "Failed to insert player";
-			errorResponse["details"] = e.what();
-			std::cerr << "Error: " << errorResponse.dump() << std::endl;
-			return crow::response(500, errorResponse.dump());
+
+		std::shared_ptr<const mapgen::Map> map = mapCache.Find(hash);
+		if (!map) {
+			return crow::response(404, "Map not found");
 		}
+
+		crow::json::wvalue response;
+		response["hash"] = mapgen::FormatHash(map->hash);
+		response["seed"] = map->seed;
+		response["height"] = map->height;
+		response["width"] = map->width;
+		response["difficulty"] = map->difficulty;
+		std::string cells(map->cells.size(), '0');
+		std::transform(map->cells.begin(), map->cells.end(), cells.begin(), [](uint8_t type) {
+			return static_cast<char>('0' + type);
+			});
+		response["cells"] = std::move(cells); // one digit per cell, row-major
+
+		crow::response mapResponse(response);
+		mapResponse.set_header("ETag", tag);
+		mapResponse.set_header("Cache-Control", "public, max-age=31536000, immutable");
+		return mapResponse;
 		});
 
-	CROW_ROUTE(app, "/game").methods("GET"_method)([&b](const crow::request& req) {
-		// Lambda function
-		auto createGameResponse = [&]() {
-			return crow::response(b.GetBoardState().dump());
-			};
+	// Prometheus scrape target: per-route request latencies and counts, tick durations, state lock
+	// waits, SQLite query times and the players and bullets of every room (see ServerMetrics.h)
+	CROW_ROUTE(app, "/metrics").methods("GET"_method)([&metrics, &rooms]() {
+		crow::response response(200, metrics.Expose(rooms));
+		response.set_header("Content-Type", "text/plain; version=0.0.4");
+		return response;
+		});
 
-		if (req.method == "GET"_method) {
-			return createGameResponse();  // Lambda call
+	// Tick phases, lock waits and serialization of the last ?seconds=<s> (5 by default) as Chrome
+	// trace_event JSON: save the body and open it in Perfetto (ui.perfetto.dev) or chrome://tracing
+	CROW_ROUTE(app, "/trace").methods("GET"_method)([](const crow::request& req) {
+		double seconds = DEFAULT_TRACE_SECONDS;
+		if (const char* requested = req.url_params.get("seconds")) {
+			char* end = nullptr;
+			seconds = std::strtod(requested, &end);
+			if (end == requested || *end != '\0' || !(seconds > 0.0 && seconds <= MAX_TRACE_SECONDS)) {
+				return crow::response(400, "Invalid trace window");
+			}
 		}
 
-		return crow::response(405, "Method Not Allowed");
+		auto window = std::chrono::duration_cast<trace::Clock::duration>(std::chrono::duration<double>(seconds));
+		crow::response response(200, trace::ExportChromeTrace(window));
+		response.set_header("Content-Type", "application/json");
+		response.set_header("Content-Disposition", "attachment; filename=\"battlecity-trace.json\"");
+		return response;
 		});
 
-	CROW_ROUTE(app, "/action/<int>/<string>")([&b](int playerId, std::string key) {
-		std::lock_guard<std::mutex> lock(gameMutex);// Protect the shared state
+	CROW_ROUTE(app, "/mapCacheStats").methods("GET"_method)([&mapCache]() {
+		crow::json::wvalue response;
+		response["capacityBytes"] = mapCache.GetCapacityBytes();
+		response["sizeBytes"] = mapCache.GetSizeBytes();
+		response["maps"] = mapCache.GetMapCount();
+		response["diskTier"] = mapCache.HasDiskTier();
+		response["diskCapacityBytes"] = mapCache.GetDiskCapacityBytes();
+		response["diskSizeBytes"] = mapCache.GetDiskSizeBytes();
+		response["memoryHits"] = mapCache.GetMemoryHitCount();
+		response["diskHits"] = mapCache.GetDiskHitCount();
+		response["misses"] = mapCache.GetMissCount();
+		response["evictions"] = mapCache.GetEvictionCount();
+		return crow::response(response);
+		});
 
-		// Player Log
-		std::ofstream logFile("log.txt", std::ios_base::app);
-		if (logFile.is_open()) {
-			logFile << "Log file created. Server started.\n";
-			logFile << "Player ID: " << playerId << ", Action: " << key << ", Timestamp: "
-				<< std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()) << "\n";
+	CROW_ROUTE(app, "/mapPoolStats").methods("GET"_method)([&mapPool]() {
+		crow::json::wvalue response;
+		response["bucketCapacity"] = mapPool.GetBucketCapacity();
+		response["hits"] = mapPool.GetHitCount();
+		response["misses"] = mapPool.GetMissCount();
+		response["hitRate"] = mapPool.GetHitRate();
+		response["refills"] = mapPool.GetRefillCount();
+		response["lastRefillMicroseconds"] = mapPool.GetLastRefillTime();
+		response["meanRefillMicroseconds"] = mapPool.GetMeanRefillTime();
+		response["maxRefillMicroseconds"] = mapPool.GetMaxRefillTime();
+
+		crow::json::wvalue::list buckets;
+		for (const MapPool::BucketStats& bucket : mapPool.GetBuckets()) {
+			crow::json::wvalue bucketJson;
+			bucketJson["difficulty"] = bucket.difficulty;
+			bucketJson["height"] = bucket.height;
+			bucketJson["width"] = bucket.width;
+			bucketJson["ready"] = bucket.ready;
+			bucketJson["pending"] = bucket.pending;
+			buckets.push_back(std::move(bucketJson));
 		}
+		response["buckets"] = std::move(buckets);
+		return crow::response(response);
+		});
 
-		if (key[0] != 'f' && key[0] != 'F')
-			b.Move(playerId, key[0]);
-		else
-		{
-			b.Shoot(playerId);
-		}
+	CROW_ROUTE(app, "/bulletsCoord").methods("GET"_method)([&](const crow::request& req) {
+		return withRoom(DEFAULT_ROOM, [&](Board& b) { return bulletsResponse(b, req); });
+		});
 
-		crow::json::wvalue updatedBoard = b.GetBoardState();  // Get the updated board state
-		return crow::response{ updatedBoard };
+	CROW_ROUTE(app, "/join").methods("POST"_method)([&](const crow::request& req) {
+		return withRoom(DEFAULT_ROOM, [&](Board& b) { return joinResponse(b, req); });
 		});
 
-	CROW_ROUTE(app, "/highScore").methods("GET"_method)([&storage](const crow::request& req) {
-		std::string playerName = req.url_params.get("name");
+	CROW_ROUTE(app, "/game").methods("GET"_method)([&](const crow::request& req) {
+		return withRoom(DEFAULT_ROOM, [&](Board& b) { return gameResponse(b, req); });
+		});
 
-		if (playerName.empty()) {
-			return crow::response(400, "Missing 'name' parameter");
+	CROW_ROUTE(app, "/snapshot").methods("GET"_method)([&](const crow::request& req) {
+		return withRoom(DEFAULT_ROOM, [&](Board& b) { return snapshotResponse(b, req); });
+		});
+
+	CROW_ROUTE(app, "/action/<int>/<string>")([&](const crow::request& req, int playerId, std::string key) {
+		return withRoom(DEFAULT_ROOM, [&](Board& b) { return actionResponse(b, req, playerId, key); });
+		});
+
+	CROW_ROUTE(app, "/changeDifficulty/<int>").methods("POST"_method)([&](int difficulty) {
+		return withRoom(DEFAULT_ROOM, [&](Board& b) { return changeDifficultyResponse(b, difficulty); });
+		});
+
+	CROW_ROUTE(app, "/getDifficulty").methods("GET"_method)([&]() {
+		return withRoom(DEFAULT_ROOM, [](Board& b) { return crow::response(std::to_string(b.GetDifficulty())); });
+		});
+
+	// Rooms
+	CROW_ROUTE(app, "/rooms").methods("GET"_method)([&rooms]() {
+		crow::json::wvalue response;
+		crow::json::wvalue::list roomList;
+
+		for (int roomId : rooms.GetRoomIds()) {
+			std::shared_ptr<Board> room = rooms.GetRoom(roomId);
+			if (!room) {
+				continue;
+			}
+			crow::json::wvalue roomJson;
+			roomJson["id"] = roomId;
+			roomJson["players"] = room->GetNumberOfPlayers();
+			roomJson["height"] = room->GetHeight();
+			roomJson["width"] = room->GetWidth();
+			roomJson["difficulty"] = room->GetDifficulty();
+			roomList.push_back(std::move(roomJson));
 		}
+		response["rooms"] = std::move(roomList);
+		return crow::response(response);
+		});
 
-		try {
-			auto player = storage.get_all<Player>(where(c(&Player::m_name) == playerName));
-			if (!player.empty()) {
-				int score = player.front().GetScore();
-				int highScore = player.front().GetHighScore();
-				crow::json::wvalue response;
-				response["score"] = score;
-				response["highScore"] = highScore;
-				return crow::response(response);
+	CROW_ROUTE(app, "/room").methods("POST"_method)([&rooms, m, n](const crow::request& req) {
+		int64_t height = m, width = n, difficulty = 1;
+		std::optional<uint32_t> mapSeed; // same seed, size and difficulty give the same walls
+
+		if (!req.body.empty()) {
+			auto body = crow::json::load(req.body);
+			if (!body) {
+				return crow::response(400, "Invalid JSON");
 			}
-			else {
-				return crow::response(404, "Player not found");
+			for (const char* field : { "height", "width", "difficulty", "seed" }) {
+				if (body.has(field) && body[field].t() != crow::json::type::Number) {
+					return crow::response(400, std::string("'") + field + "' must be a number");
+				}
+			}
+			try {
+				if (body.has("height")) height = body["height"].i();
+				if (body.has("width")) width = body["width"].i();
+				if (body.has("difficulty")) difficulty = body["difficulty"].i();
+				if (body.has("seed")) {
+					int64_t seed = body["seed"].i();
+					if (seed < 0 || seed > UINT32_MAX) {
+						return crow::response(400, "Invalid seed");
+					}
+					mapSeed = static_cast<uint32_t>(seed);
+				}
 			}
+			catch (const std::exception&) {
+				return crow::response(400, "Numbers out of range"); // e.g. beyond 64 bits
+			}
+		}
+
+		if (height < MIN_ROOM_SIDE || width < MIN_ROOM_SIDE || height > MAX_ROOM_SIDE || width > MAX_ROOM_SIDE) {
+			return crow::response(400, "Board size must be between " + std::to_string(MIN_ROOM_SIDE) + " and " + std::to_string(MAX_ROOM_SIDE));
+		}
+		if (difficulty < 1 || difficulty > 4) {
+			return crow::response(400, "Invalid difficulty level");
+		}
+
+		try {
+			crow::json::wvalue response;
+			response["roomId"] = rooms.CreateRoom(static_cast<int>(height), static_cast<int>(width), static_cast<int>(difficulty), mapSeed);
+			return crow::response(201, response);
 		}
 		catch (const std::exception& e) {
-			return crow::response(500, "Server error: " + std::string(e.what()));
+			return crow::response(503, "Failed to create room: " + std::string(e.what()));
 		}
 		});
 
-	std::unordered_map<int, int> difficultyVotes;
-
-	CROW_ROUTE(app, "/changeDifficulty/<int>").methods("POST"_method)([&b](int difficulty) {
-		if (difficulty < 1 || difficulty > 4) {
-			return crow::response(400, "Invalid difficulty level");
+	CROW_ROUTE(app, "/room/<int>").methods("DELETE"_method)([&rooms](int roomId) {
+		if (roomId == DEFAULT_ROOM) {
+			return crow::response(403, "The default room cannot be closed");
+		}
+		if (!rooms.RemoveRoom(roomId)) {
+			return crow::response(404, "Room not found");
 		}
+		return crow::response(200, "Room closed");
+		});
 
-		b.SetDifficultyAsValue(difficulty);
-		b.GenerateBoard();
+	CROW_ROUTE(app, "/room/<int>/tickStats").methods("GET"_method)([&](int roomId) {
+		return withRoom(roomId, tickStatsResponse);
+		});
 
-		return crow::response(200, "Difficulty updated and board regenerated");
+	CROW_ROUTE(app, "/room/<int>/inputStats").methods("GET"_method)([&](int roomId) {
+		return withRoom(roomId, inputStatsResponse);
+		});
+
+	CROW_ROUTE(app, "/room/<int>/bulletsCoord").methods("GET"_method)([&](const crow::request& req, int roomId) {
+		return withRoom(roomId, [&](Board& b) { return bulletsResponse(b, req); });
+		});
+
+	CROW_ROUTE(app, "/room/<int>/join").methods("POST"_method)([&](const crow::request& req, int roomId) {
+		return withRoom(roomId, [&](Board& b) { return joinResponse(b, req); });
+		});
+
+	CROW_ROUTE(app, "/room/<int>/game").methods("GET"_method)([&](const crow::request& req, int roomId) {
+		return withRoom(roomId, [&](Board& b) { return gameResponse(b, req); });
+		});
+
+	CROW_ROUTE(app, "/room/<int>/snapshot").methods("GET"_method)([&](const crow::request& req, int roomId) {
+		return withRoom(roomId, [&](Board& b) { return snapshotResponse(b, req); });
 		});
 
-	CROW_ROUTE(app, "/getDifficulty").methods("GET"_method)([&b]() {
-		return crow::response(std::to_string(b.GetDifficulty()));
+	CROW_ROUTE(app, "/room/<int>/action/<int>/<string>")([&](const crow::request& req, int roomId, int playerId, std::string key) {
+		return withRoom(roomId, [&](Board& b) { return actionResponse(b, req, playerId, key); });
 		});
 
+	CROW_ROUTE(app, "/room/<int>/changeDifficulty/<int>").methods("POST"_method)([&](int roomId, int difficulty) {
+		return withRoom(roomId, [&](Board& b) { return changeDifficultyResponse(b, difficulty); });
+		});
+
+	// Push channel: every tick's frame (binary, see WireFormat.h) goes to the room's subscribers.
+	// Upstream text frames are JSON:
+	//   {"type": "subscribe", "room": <id>, "player": <id>}
+	//   {"type": "input", "key": "<w|a|s|d|f>"}
+	auto socketError = [](crow::websocket::connection& conn, const std::string& error) {
+		crow::json::wvalue message;
+		message["error"] = error;
+		conn.send_text(message.dump());
+		};
+
+	// Drops a room's tick listener once its last subscriber has left, so the room stops encoding frames
+	// nobody receives. The count is read under the state lock, the same lock a new subscriber installs
+	// the listener under, so a subscriber arriving meanwhile is never left without frames.
+	auto releaseTickListener = [&rooms, &subscribers](int roomId) {
+		std::shared_ptr<Board> room = rooms.GetRoom(roomId);
+		if (!room) {
+			return;
+		}
+
+		auto stateLock = room->LockState();
+		if (subscribers.GetSubscriberCount(roomId) == 0) {
+			room->SetTickListener(nullptr);
+		}
+		};
+
+	CROW_WEBSOCKET_ROUTE(app, "/ws")
+		.onclose([&subscribers, &releaseTickListener](crow::websocket::connection& conn, const std::string& reason) {
+			auto subscription = subscribers.GetSubscription(conn);
+			subscribers.Unsubscribe(conn);
+			if (subscription) {
+				releaseTickListener(subscription->roomId);
+			}
+			})
+		.onmessage([&](crow::websocket::connection& conn, const std::string& data, bool isBinary) {
+			auto message = crow::json::load(data);
+			if (isBinary || !message || !message.has("type")) {
+				socketError(conn, "Invalid message");
+				return;
+			}
+
+			std::string type = message["type"].s();
+			if (type == "subscribe") {
+				int roomId = message.has("room") ? static_cast<int>(message["room"].i()) : DEFAULT_ROOM;
+				int playerId = message.has("player") ? static_cast<int>(message["player"].i()) : -1;
+				std::shared_ptr<Board> room = rooms.GetRoom(roomId);
+				if (!room) {
+					socketError(conn, "Room not found");
+					return;
+				}
+
+				auto previous = subscribers.GetSubscription(conn);
+				subscribers.Subscribe(conn, roomId, playerId);
+				if (previous && previous->roomId != roomId) {
+					releaseTickListener(previous->roomId);
+				}
+
+				{
+					auto stateLock = room->LockState();
+					room->SetTickListener([&subscribers, roomId](const std::string& tickFrame) {
+						subscribers.Broadcast(roomId, tickFrame);
+						});
+				}
+
+				std::string frame;
+				room->GetLatestSnapshot()->EncodeFrame(frame);
+				conn.send_binary(frame);
+			}
+			else if (type == "input") {
+				auto subscription = subscribers.GetSubscription(conn);
+				if (!subscription || subscription->playerId < 0) {
+					socketError(conn, "Subscribe as a player first");
+					return;
+				}
+
+				std::string key = message.has("key") ? std::string(message["key"].s()) : std::string();
+				std::optional<InputCommand> command = parseAction(subscription->playerId, key);
+				std::shared_ptr<Board> room = rooms.GetRoom(subscription->roomId);
+				if (!command || !room) {
+					socketError(conn, "Invalid input");
+					return;
+				}
+
+				logAction(subscription->playerId, key);
+				if (!room->SubmitInput(std::move(*command))) {
+					socketError(conn, "Too many pending inputs");
+				}
+			}
+			else {
+				socketError(conn, "Unknown message type");
+			}
+			});
+
 	CROW_ROUTE(app, "/closeGame").methods("POST"_method)([&]() {
 		// Code to handle the game closure logic
 		std::cout << "Game is closing." << std::endl;
@@ -297,4 +877,4 @@ int main() {
 
 	app.port(18080).multithreaded().run();
 	return 0;
-}
\ No newline at end of file
+}